@@ -0,0 +1,191 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_ALLOCATION_COUNTERS_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_ALLOCATION_COUNTERS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <malloc.h>
+#include <memory>
+#include <new>
+#include <unistd.h>
+
+/**\brief The heap allocations done by one or more threads.
+ *
+ * The byte counts are the usable sizes reported by \c malloc_usable_size and
+ * therefore include the rounding of the allocator. The counters are only
+ * updated by their own thread, so the counting doesn't add shared cache lines
+ * to the measured code.
+ *
+ * The heap bytes of a thread are the bytes it allocated minus the ones it
+ * freed (they become negative if it frees blocks of other threads), so only
+ * their sum over the threads is the heap growth of all of them.
+ */
+struct AllocationCounters {
+    uint_fast64_t   allocations = 0;
+    uint_fast64_t   deallocations = 0;
+    uint_fast64_t   allocatedBytes = 0;
+    int_fast64_t    heapBytes = 0;
+
+    void merge(const AllocationCounters& other) {
+        allocations += other.allocations;
+        deallocations += other.deallocations;
+        allocatedBytes += other.allocatedBytes;
+        heapBytes += other.heapBytes;
+    }
+};
+
+/// The allocations are only counted once this got set (it's not reset as the heap bytes would drift otherwise).
+inline std::atomic<bool>            allocationCountingEnabled(false);
+
+/// The allocations of the calling thread (they have to be merged after the threads completed).
+inline thread_local AllocationCounters threadAllocationCounters;
+
+inline void countAllocatedBytes(std::size_t size) {
+    if (!allocationCountingEnabled.load(std::memory_order_relaxed)) return;
+
+    AllocationCounters& counters = threadAllocationCounters;
+    counters.allocations++;
+    counters.allocatedBytes += size;
+    counters.heapBytes += int_fast64_t(size);
+}
+
+inline void countAllocation(void* pointer) {
+    if (!pointer || !allocationCountingEnabled.load(std::memory_order_relaxed)) return;
+
+    countAllocatedBytes(malloc_usable_size(pointer));
+}
+
+inline void countDeallocatedBytes(std::size_t size) {
+    if (!allocationCountingEnabled.load(std::memory_order_relaxed)) return;
+
+    AllocationCounters& counters = threadAllocationCounters;
+    counters.deallocations++;
+    counters.heapBytes -= int_fast64_t(size);
+}
+
+inline void countDeallocation(void* pointer) {
+    if (!pointer || !allocationCountingEnabled.load(std::memory_order_relaxed)) return;
+
+    countDeallocatedBytes(malloc_usable_size(pointer));
+}
+
+/*
+ * The allocation functions of the C library are interposed to count every
+ * heap allocation of the executable and of the libraries it uses, including
+ * the ones done through operator new/delete (which call malloc and free) and
+ * the ones of containers calling malloc directly. The interposed functions
+ * forward to the implementations of glibc through their __libc_* aliases (a
+ * lookup with dlsym(RTLD_NEXT, ...) could allocate itself). As the
+ * interposed functions have to be defined exactly once, this header must only
+ * be included by a single translation unit per executable (like the rest of
+ * the evaluation framework).
+ */
+
+extern "C" {
+
+void* __libc_malloc(std::size_t size) noexcept;
+void* __libc_calloc(std::size_t count, std::size_t size) noexcept;
+void* __libc_realloc(void* pointer, std::size_t size) noexcept;
+void* __libc_memalign(std::size_t alignment, std::size_t size) noexcept;
+void __libc_free(void* pointer) noexcept;
+
+void* malloc(std::size_t size) noexcept {
+    void* pointer = __libc_malloc(size);
+    countAllocation(pointer);
+    return pointer;
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept {
+    void* pointer = __libc_calloc(count, size);
+    countAllocation(pointer);
+    return pointer;
+}
+
+// A reallocation is counted as the deallocation of the old block and the allocation of the new one:
+void* realloc(void* pointer, std::size_t size) noexcept {
+    std::size_t oldSize = pointer ? malloc_usable_size(pointer) : 0;
+    void* newPointer = __libc_realloc(pointer, size);
+    if (pointer && (newPointer || size == 0)) countDeallocatedBytes(oldSize);
+    countAllocation(newPointer);
+    return newPointer;
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept {
+    void* pointer = __libc_memalign(alignment, size);
+    countAllocation(pointer);
+    return pointer;
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, std::size_t alignment, std::size_t size) noexcept {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* allocated = memalign(alignment, size);
+    if (!allocated) return ENOMEM;
+    *pointer = allocated;
+    return 0;
+}
+
+void* valloc(std::size_t size) noexcept {
+    return memalign(sysconf(_SC_PAGESIZE), size);
+}
+
+void free(void* pointer) noexcept {
+    countDeallocation(pointer);
+    __libc_free(pointer);
+}
+
+}
+
+/**\brief A standard allocator counting the blocks it takes from another allocator.
+ *
+ * Allocators which don't take their memory from malloc (like
+ * \c tbb::cache_aligned_allocator using the scalable allocator of TBB) aren't
+ * counted through the interposed functions, so they can be wrapped in this
+ * one. The blocks are counted with their requested size.
+ */
+template <typename T, typename Allocator>
+class CountingAllocator {
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef CountingAllocator<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>> other;
+    };
+
+    CountingAllocator() noexcept {}
+
+    template <typename U, typename OtherAllocator>
+    CountingAllocator(const CountingAllocator<U, OtherAllocator>& other) noexcept : allocator(other.allocator) {}
+
+    T* allocate(std::size_t count) {
+        T* pointer = allocator.allocate(count);
+        countAllocatedBytes(count * sizeof(T));
+        return pointer;
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        countDeallocatedBytes(count * sizeof(T));
+        allocator.deallocate(pointer, count);
+    }
+
+    template <typename U, typename OtherAllocator>
+    bool operator==(const CountingAllocator<U, OtherAllocator>& other) const noexcept {
+        return allocator == other.allocator;
+    }
+
+    template <typename U, typename OtherAllocator>
+    bool operator!=(const CountingAllocator<U, OtherAllocator>& other) const noexcept {
+        return !(*this == other);
+    }
+
+    Allocator   allocator;
+};
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_ALLOCATION_COUNTERS_HPP
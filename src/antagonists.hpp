@@ -0,0 +1,189 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_ANTAGONISTS_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_ANTAGONISTS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread_placement.hpp"
+
+enum AntagonistType {
+    LLC_THRASHER,
+    BANDWIDTH_HOG,
+    FALSE_SHARING
+};
+
+/**\brief A kind of antagonist threads co-running with the worker threads.
+ *
+ * The intensity is the fraction of each millisecond an antagonist thread is
+ * active (1.0 is all the time).
+ */
+struct AntagonistSpecification {
+    AntagonistType  type;
+    uint_fast32_t   count;
+    double          intensity;
+};
+
+/**\brief Parses an antagonist specification like "llc:2:0.5" (type[:count[:intensity]]).
+ *
+ * \throws std::invalid_argument if the specification is malformed.
+ */
+inline AntagonistSpecification parseAntagonist(const std::string& specification) {
+    std::vector<std::string> parts;
+    std::istringstream stream(specification);
+    std::string part;
+    while (std::getline(stream, part, ':')) parts.push_back(part);
+    if (parts.empty() || parts.size() > 3) throw std::invalid_argument(specification);
+
+    AntagonistSpecification antagonist;
+    if (parts[0] == "llc") {
+        antagonist.type = LLC_THRASHER;
+    } else if (parts[0] == "bandwidth") {
+        antagonist.type = BANDWIDTH_HOG;
+    } else if (parts[0] == "false_sharing") {
+        antagonist.type = FALSE_SHARING;
+    } else {
+        throw std::invalid_argument(specification);
+    }
+    antagonist.count = parts.size() > 1 ? uint_fast32_t(std::stoul(parts[1])) : 1;
+    antagonist.intensity = parts.size() > 2 ? std::stod(parts[2]) : 1.0;
+    if (antagonist.count == 0 || antagonist.intensity <= 0.0 || antagonist.intensity > 1.0) throw std::invalid_argument(specification);
+    return antagonist;
+}
+
+inline std::string antagonistName(AntagonistType type) {
+    switch (type) {
+        case LLC_THRASHER:  return "llc";
+        case BANDWIDTH_HOG: return "bandwidth";
+        case FALSE_SHARING: return "false_sharing";
+        default:            return "unknown";
+    }
+}
+
+/// The size of the last level cache of CPU 0 in bytes (32MiB if it's unknown).
+inline uint_fast64_t lastLevelCacheSize() {
+    uint_fast64_t size = 32 << 20;
+    uint_fast32_t highestLevel = 0;
+    for (uint_fast32_t index = 0; index < 8; index++) {
+        std::string cache = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::ifstream levelFile(cache + "level");
+        std::ifstream sizeFile(cache + "size");
+        uint_fast32_t level;
+        uint_fast64_t cacheSize;
+        std::string unit;
+        if (!(levelFile >> level) || !(sizeFile >> cacheSize)) continue;
+        sizeFile >> unit;
+        if (unit == "K") cacheSize <<= 10;
+        if (unit == "M") cacheSize <<= 20;
+        if (level > highestLevel) {
+            highestLevel = level;
+            size = cacheSize;
+        }
+    }
+    return size;
+}
+
+/**\brief Threads interfering with the worker threads while they exist.
+ *
+ * - LLC thrasher:     read-modify-writes random cache lines of a buffer twice the size of the LLC
+ * - bandwidth hog:    streams through a buffer four times the size of the LLC, copying its first half to its second half
+ * - false sharing:    all false sharing threads increment their own counter in the same cache line
+ *
+ * The constructor returns once all the antagonists allocated and touched
+ * their buffers and started to interfere.
+ */
+class Antagonists {
+public:
+    Antagonists(const std::vector<AntagonistSpecification>& specifications, const std::vector<uint_fast32_t>& cpus) :
+            running(true),
+            ready(0),
+            falseSharingLine(new FalseSharingLine()) {
+        uint_fast64_t bufferSize = lastLevelCacheSize();
+        uint_fast32_t index = 0;
+        uint_fast32_t falseSharingIndex = 0;
+        for (const AntagonistSpecification& specification : specifications) {
+            for (uint_fast32_t i = 0; i < specification.count; i++, index++) {
+                int_fast64_t cpu = cpus.empty() ? -1 : int_fast64_t(cpus[index % cpus.size()]);
+                uint_fast32_t counter = specification.type == FALSE_SHARING ? falseSharingIndex++ % 8 : 0;
+                threads.emplace_back([this, specification, cpu, bufferSize, counter]{
+                    if (cpu >= 0) pinThisThread(uint_fast32_t(cpu));
+                    switch (specification.type) {
+                        case LLC_THRASHER:  thrashCache(specification.intensity, 2 * bufferSize); break;
+                        case BANDWIDTH_HOG: hogBandwidth(specification.intensity, 4 * bufferSize); break;
+                        case FALSE_SHARING: shareFalsely(specification.intensity, falseSharingLine->counters[counter]); break;
+                    }
+                });
+            }
+        }
+        while (ready < threads.size()) std::this_thread::yield();
+    }
+
+    ~Antagonists() {
+        running = false;
+        for (std::thread& thread : threads) thread.join();
+    }
+
+private:
+    struct alignas(64) FalseSharingLine {
+        std::atomic<uint64_t>   counters[8];
+    };
+
+    /// Runs the step in batches until the antagonists get stopped, active only for the given fraction of each millisecond.
+    template <typename Step>
+    void interfere(double intensity, Step step) {
+        ready++;
+        const auto period = std::chrono::microseconds(1000);
+        const auto activeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(period * intensity);
+        while (running) {
+            auto start = std::chrono::steady_clock::now();
+            while (std::chrono::steady_clock::now() - start < activeTime && running) {
+                for (uint_fast32_t i = 0; i < 256; i++) step();
+            }
+            if (intensity < 1.0) std::this_thread::sleep_until(start + period);
+        }
+    }
+
+    void thrashCache(double intensity, uint_fast64_t bufferSize) {
+        uint_fast64_t lines = bufferSize / 64;
+        std::unique_ptr<uint64_t[]> buffer(new uint64_t[lines * 8]());
+        uint64_t random = 88172645463325252ull;
+        interfere(intensity, [&]{
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            buffer[(random % lines) * 8]++;
+        });
+    }
+
+    void hogBandwidth(double intensity, uint_fast64_t bufferSize) {
+        uint_fast64_t words = bufferSize / sizeof(uint64_t) / 2;
+        std::unique_ptr<uint64_t[]> buffer(new uint64_t[2 * words]());
+        uint_fast64_t position = 0;
+        interfere(intensity, [&]{
+            for (uint_fast32_t i = 0; i < 64; i++) {
+                buffer[words + position] = buffer[position] + 1;
+                position = position + 1 == words ? 0 : position + 1;
+            }
+        });
+    }
+
+    void shareFalsely(double intensity, std::atomic<uint64_t>& counter) {
+        interfere(intensity, [&]{
+            counter.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    std::atomic<bool>                   running;
+    std::atomic<size_t>                 ready;
+    std::vector<std::thread>            threads;
+    std::unique_ptr<FalseSharingLine>   falseSharingLine;
+};
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_ANTAGONISTS_HPP
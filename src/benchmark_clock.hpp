@@ -0,0 +1,88 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_BENCHMARK_CLOCK_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_BENCHMARK_CLOCK_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+/**\brief The clock used to time the benchmark and the individual operations.
+ *
+ * If the CPU has an invariant TSC (it ticks at a constant rate independent of
+ * frequency scaling and C-states and it's synchronized across cores), reading
+ * it is a single unserialized instruction and therefore much cheaper than
+ * \c clock_gettime. Its frequency gets calibrated against
+ * \c std::chrono::steady_clock. Otherwise, \c std::chrono::steady_clock is
+ * used and a tick is a nanosecond.
+ */
+class BenchmarkClock {
+public:
+    enum Source {
+        CHRONO,
+        TSC
+    };
+
+    static bool invariantTSCAvailable() {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) return false;
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        return edx & (1 << 8);
+#else
+        return false;
+#endif
+    }
+
+    /// Selects the clock source and calibrates the TSC if it gets used.
+    static void select(Source clockSource) {
+        source = clockSource;
+        ticksPerNSValue = 1.0;
+        if (source == TSC) calibrate();
+    }
+
+    static Source selected() {
+        return source;
+    }
+
+    static inline uint_fast64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        if (source == TSC) return __rdtsc();
+#endif
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    static inline uint_fast64_t toNanoseconds(uint_fast64_t ticks) {
+        return source == TSC ? uint_fast64_t(double(ticks) / ticksPerNSValue) : ticks;
+    }
+
+    static double ticksPerNS() {
+        return ticksPerNSValue;
+    }
+
+private:
+    /// The median of five 20ms rounds to be robust against preemption during a round.
+    static void calibrate() {
+        std::array<double, 5> rounds;
+        for (double& round : rounds) {
+            auto startTime = std::chrono::steady_clock::now();
+            uint_fast64_t startTicks = now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            uint_fast64_t stopTicks = now();
+            auto stopTime = std::chrono::steady_clock::now();
+            round = double(stopTicks - startTicks) / double(std::chrono::nanoseconds(stopTime - startTime).count());
+        }
+        std::sort(rounds.begin(), rounds.end());
+        ticksPerNSValue = rounds[rounds.size() / 2];
+    }
+
+    static inline Source    source = CHRONO;
+    static inline double    ticksPerNSValue = 1.0;
+};
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_BENCHMARK_CLOCK_HPP
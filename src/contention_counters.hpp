@@ -0,0 +1,64 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_CONTENTION_COUNTERS_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_CONTENTION_COUNTERS_HPP
+
+#include <cstdint>
+
+#include "benchmark_clock.hpp"
+
+enum ContentionCounter {
+    ENQUEUE_CAS_FAILURES,
+    ENQUEUE_RETRIES,            // the enqueue position was taken by another thread
+    DEQUEUE_CAS_FAILURES,
+    DEQUEUE_RETRIES,            // the dequeue position was taken by another thread
+    LOCK_ACQUISITIONS,
+    LOCK_CAS_FAILURES,
+    LOCK_SPIN_ITERATIONS,
+    LOCK_WAIT_TICKS,            // BenchmarkClock ticks
+    LOCK_HOLD_TICKS,            // BenchmarkClock ticks
+    STEALS,                     // pages stolen from another shard of a sharded free list
+    STEAL_FAILURES,             // all the other shards were empty
+    REMOTE_POPS,                // pages of another NUMA node popped by the NUMA-aware free list
+    CONTENTION_COUNTER_COUNT
+};
+
+constexpr const char* contentionCounterNames[CONTENTION_COUNTER_COUNT] = {
+        "Enqueue CAS Failures",
+        "Enqueue Retries",
+        "Dequeue CAS Failures",
+        "Dequeue Retries",
+        "Lock Acquisitions",
+        "Lock CAS Failures",
+        "Lock Spin Iterations",
+        "Lock Wait Time",
+        "Lock Hold Time",
+        "Steals",
+        "Failed Steals",
+        "Remote Pops"
+};
+
+struct ContentionCounters {
+    uint_fast64_t   values[CONTENTION_COUNTER_COUNT] = {};
+
+    void merge(const ContentionCounters& other) {
+        for (uint_fast32_t i = 0; i < CONTENTION_COUNTER_COUNT; i++) values[i] += other.values[i];
+    }
+};
+
+/**\brief The contention counters of the calling thread.
+ *
+ * They are incremented by the instrumented synchronization code in
+ * \c src/third_party and have to be merged after the threads completed.
+ */
+inline thread_local ContentionCounters threadContentionCounters;
+
+#ifdef ZERO_EVALUATION_CONTENTION
+
+#define CONTENTION_COUNT(counter, value) (threadContentionCounters.values[(counter)] += (value))
+
+#else // ZERO_EVALUATION_CONTENTION
+
+#define CONTENTION_COUNT(counter, value) do {} while (false)
+
+#endif // ZERO_EVALUATION_CONTENTION
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_CONTENTION_COUNTERS_HPP
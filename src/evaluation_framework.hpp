@@ -1,6 +1,7 @@
 #ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_EVALUATION_FRAMEWORK_HPP
 #define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_EVALUATION_FRAMEWORK_HPP
 
+#include <cctype>
 #include <chrono>
 #include <random>
 #include <thread>
@@ -9,9 +10,26 @@
 #include <boost/program_options.hpp>
 #include <sys/ioctl.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <tuple>
+#include <vector>
+
+#include "allocation_counters.hpp"
+#include "antagonists.hpp"
+#include "benchmark_clock.hpp"
+#include "latency_histogram.hpp"
+#include "performance_counters.hpp"
+#include "result_records.hpp"
+#include "spin_barrier.hpp"
+#include "statistics.hpp"
+#include "thread_placement.hpp"
 
 template <typename Container, typename Fun>
 void tupleForEach(const Container &c, Fun fun) {
@@ -47,6 +65,52 @@ std::ostream &operator<<(std::ostream &stream, std::chrono::nanoseconds time) {
 
 namespace po = boost::program_options;
 
+/**\brief The progress of a worker thread as read by the timeline sampler.
+ *
+ * Each worker thread only ever stores to its own cache line and the sampler
+ * only loads from it, so the hot path doesn't contend on a shared counter.
+ */
+struct alignas(64) ThreadProgress {
+    std::atomic<uint_fast64_t>  operations;
+    std::atomic<int_fast64_t>   heapBytes;          // the heap bytes of the thread since its start (if allocations are counted)
+    uint_fast64_t               startTime;          // BenchmarkClock ticks
+    uint_fast64_t               completionTime;     // BenchmarkClock ticks
+};
+
+struct TimelineSample {
+    uint_fast64_t   timeInNS;
+    uint_fast64_t   operations;
+    double          operationsPerSecond;
+    bool            specificAvailable;
+    int_fast64_t    specific;
+};
+
+/**\brief When the worker threads start their operations.
+ *
+ * In the closed loop, a thread starts its next operation as soon as the
+ * previous one completed. In the open loop, the operations arrive according
+ * to a schedule at a given rate, independent of how long the previous
+ * operations took, and their response time is measured from their scheduled
+ * arrival. Therefore, the response time includes the time an operation had to
+ * wait for its predecessors and doesn't suffer from coordinated omission.
+ */
+enum ArrivalProcess {
+    CLOSED,
+    CONSTANT,
+    POISSON
+};
+
+/**\brief A parameter varied by a sweep together with the values it takes.
+ *
+ * \c apply sets one of the values before the configuration of a cell gets
+ * applied and throws \c std::logic_error if the value is invalid.
+ */
+struct SweepDimension {
+    std::string                                 name;
+    std::vector<std::string>                    values;
+    std::function<void(const std::string&)>     apply;
+};
+
 class Evaluation {
 public:
     Evaluation(std::string name) : name(name) {
@@ -65,20 +129,27 @@ public:
         setSpecificOptions();
         combineOptions();
         parseSettings(argc, argv);
-        setSpecificConfig();
-
-        initialize();
-        printConfiguration();
 
-        runTimeoutThread();
-
-        runBenchmark();
+        // Each combination of the swept values is a cell which gets configured and measured on its own:
+        std::vector<SweepDimension> dimensions = sweepDimensions();
+        std::vector<size_t> cell(dimensions.size(), 0);
+        do {
+            for (size_t d = 0; d < dimensions.size(); d++) {
+                try {
+                    dimensions[d].apply(dimensions[d].values[cell[d]]);
+                } catch (std::logic_error& e) {
+                    std::cerr << "ERROR: " << "The argument " << dimensions[d].values[cell[d]] << " is invalid for option --sweep_" << dimensions[d].name << "." << std::endl << std::endl;
+                    std::cerr << *allOptions << std::endl;
+                    exit(1);
+                }
+            }
+            setSpecificConfig();
+            placeThreads();
 
-        printResult(timeElapsed);
-        unInitialize();
+            runCell();
+        } while (nextCell(dimensions, cell));
 
-        exit(0);
-        timeoutThread->join();
+        exit(baselineFile.empty() ? 0 : compareWithBaseline(dimensions));
     }
 
 protected:
@@ -91,22 +162,117 @@ protected:
 
     uint_fast32_t               threadCount;
     uint_fast64_t               iterationsCount;
+    uint_fast64_t               warmUpIterationsCount;
+    uint_fast32_t               trialCount;
+    uint_fast32_t               maxTrialCount;
+    double                      confidenceIntervalWidth;
+    double                      outlierThreshold;
     uint_fast64_t               timeoutInNS;
     bool                        extendedOutput;
     bool                        debugOutput;
+    bool                        collectCounters;
+    uint_fast64_t               cacheToCacheEvent;
+    bool                        countAllocations;
+
+    std::string                 placementPolicy;
+    std::vector<uint_fast32_t>  threadPlacement;
+    uint_fast64_t               sampleIntervalInMS;
+    std::string                 timelineFile;
+
+    std::vector<AntagonistSpecification> antagonistSpecifications;
+    bool                        antagonistsActive;
+
+    ArrivalProcess              arrivalProcess;
+    double                      offeredRate;        // operations per second across all threads
+    LatencyHistogram            responseTime;
+    std::mutex                  responseTimeMutex;
+
+    std::string                 resultsFile;
+    std::string                 baselineFile;
+    double                      significanceLevel;
+    double                      regressionThreshold;
+    std::unique_ptr<ResultWriter> resultWriter;
+    std::vector<ResultRecord>   cellRecords;
 
     uint_fast64_t               timeElapsed;
+    PerformanceCounterSample    counterSample;
+    std::mutex                  counterSampleMutex;
+    AllocationCounters          allocationCounters;
+    std::mutex                  allocationCountersMutex;
+    int_fast64_t                peakHeapBytes;
 
     std::thread**               threads;
     std::thread*                timeoutThread;
+    std::mutex                  timeoutMutex;
+    std::condition_variable     timeoutCondition;
+    bool                        timeoutCancelled;
+    std::thread*                samplerThread;
+
+    ThreadProgress*             threadProgress;
+    std::unique_ptr<SpinBarrier> startBarrier;
+    std::vector<double>         threadCompletionTimes;
+    std::atomic<bool>           samplerRunning;
+    std::vector<TimelineSample> timeline;
 
 private:
+    std::string                 cacheToCacheEventString;
+    std::string                 clockSourceName;
+    std::string                 sweepThreads;
+    std::string                 arrivalProcessName;
+    std::string                 sweepRates;
+    std::vector<std::string>    antagonistOptions;
+    std::string                 resultsFormat;
+    std::vector<uint_fast32_t>  placementOrder;
+
     void setOptions() {
         generalOptions->add_options()
                 ("help,h", "Print this help messages.")
                 ("threads,t", po::value<uint_fast32_t>(&threadCount)->default_value(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1)->notifier([](uint_fast32_t value) { if (value <= 0) {throw po::invalid_option_value(std::to_string(value));}}), "Number of threads to use.")
                 ("iterations,i", po::value<uint_fast32_t>(&iterationsCount)->default_value(1000000)->notifier([](uint_fast32_t value) { if (value <= 0) {throw po::invalid_option_value(std::to_string(value));}}), "Number of iterations per thread.")
+                ("warmup", po::value<uint_fast64_t>(&warmUpIterationsCount)->default_value(0), "Number of iterations per thread executed before the measurement starts.")
+                ("trials", po::value<uint_fast32_t>(&trialCount)->default_value(1)->notifier([](uint_fast32_t value) { if (value <= 0) {throw po::invalid_option_value(std::to_string(value));}}), "Number of times each configuration gets measured (the data structure is rebuilt for each trial).")
+                ("max_trials", po::value<uint_fast32_t>(&maxTrialCount)->default_value(100), "Maximum number of trials per configuration if --ci_width is set.")
+                ("ci_width", po::value<double>(&confidenceIntervalWidth)->default_value(0.0, "0"), "Keep adding trials until the 95% confidence interval of the elapsed time is narrower than this fraction of its mean (e.g. 0.02, 0 disables this).")
+                ("outlier_threshold", po::value<double>(&outlierThreshold)->default_value(0.0, "0"), "Reject trials whose elapsed time has a MAD-based modified z-score above this threshold (3.5 is common, 0 disables this).")
+                ("sweep_threads", po::value<std::string>(&sweepThreads)->default_value(""), "Comma-separated numbers of threads to sweep over (overrides --threads).")
+                ("clock", po::value<std::string>(&clockSourceName)->default_value("auto"), "Clock used for the timing.\n"
+                        "Possible values:\n"
+                        "- auto (tsc if the TSC is invariant)\n"
+                        "- tsc\n"
+                        "- chrono")
+                ("arrival", po::value<std::string>(&arrivalProcessName)->default_value("closed"), "Arrival process of the operations.\n"
+                        "Possible values:\n"
+                        "- closed (each thread starts its next operation when the previous one completed)\n"
+                        "- constant (evenly spaced arrivals at --rate)\n"
+                        "- poisson (exponentially distributed inter-arrival times at --rate)")
+                ("rate", po::value<double>(&offeredRate)->default_value(1000000.0, "1000000"), "Offered load of the open-loop arrival processes in operations per second across all threads.")
+                ("sweep_rate", po::value<std::string>(&sweepRates)->default_value(""), "Comma-separated offered loads to sweep over (overrides --rate, requires an open-loop --arrival).")
+                ("placement", po::value<std::string>(&placementPolicy)->default_value("none"), "Placement of the worker threads on the CPUs.\n"
+                        "Possible values:\n"
+                        "- none (left to the scheduler)\n"
+                        "- compact (one thread per core, package by package)\n"
+                        "- smt-first (SMT siblings first, core by core)\n"
+                        "- scatter (round robin over the packages)\n"
+                        "- a CPU list like 0-3,8")
                 ("timeout", po::value<uint_fast64_t>(&timeoutInNS)->default_value(10000), "Timeout per thread and iteration until the running threads get terminated (0 is no timeout).")
+                ("sample_interval", po::value<uint_fast64_t>(&sampleIntervalInMS)->default_value(0), "Interval in milliseconds in which the throughput timeline gets sampled (0 disables the sampling).")
+                ("timeline", po::value<std::string>(&timelineFile)->default_value(""), "CSV file the throughput timeline gets written to (printed with the extended output if not set).")
+                ("antagonist", po::value<std::vector<std::string>>(&antagonistOptions)->composing(), "Threads interfering with the worker threads, given as type[:count[:intensity]] where the intensity is the active fraction of each millisecond (can be given multiple times). Each configuration is measured without and with them.\n"
+                        "Possible types:\n"
+                        "- llc (random read-modify-writes to twice the LLC size)\n"
+                        "- bandwidth (streaming copy of four times the LLC size)\n"
+                        "- false_sharing (counters in a shared cache line)")
+                ("results", po::value<std::string>(&resultsFile)->default_value(""), "File one record per configuration gets written to (including the full configuration).")
+                ("results_format", po::value<std::string>(&resultsFormat)->default_value("csv"), "Format of the results file.\n"
+                        "Possible values:\n"
+                        "- csv\n"
+                        "- json (one object per line)")
+                ("compare", po::value<std::string>(&baselineFile)->default_value(""), "Results file of a baseline run to compare against (exits with 3 if a configuration regressed).")
+                ("significance", po::value<double>(&significanceLevel)->default_value(0.05, "0.05"), "Significance level of the Welch t-test used by --compare.")
+                ("regression_threshold", po::value<double>(&regressionThreshold)->default_value(0.05, "0.05"), "Minimum relative change of the elapsed time reported by --compare.")
+                ("counters,c", po::bool_switch(&collectCounters)->default_value(false), "Collect hardware performance counters (falling back to software counters) and resource usage per worker thread.")
+                ("c2c_event", po::value<std::string>(&cacheToCacheEventString)->default_value("0x04d2"), "Raw PMU event counting cache-to-cache transfers (0x04d2 is MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM on Intel Skylake, 0 disables it).")
+                ("allocations", po::bool_switch(&countAllocations)->default_value(false), "Count the heap allocations and deallocations (through malloc/free, and so through operator new/delete) of the worker threads and sample their peak heap growth during the measurement (every --sample_interval or every millisecond).")
                 ("debug,d", po::bool_switch(&debugOutput)->default_value(false), "Print additional debug information (implies --extended).")
                 ("extended,e", po::bool_switch(&extendedOutput)->default_value(false), "Print extended output.");
     }
@@ -136,12 +302,164 @@ private:
             exit(1);
         }
 
+        try {
+            cacheToCacheEvent = std::stoull(cacheToCacheEventString, nullptr, 0);
+        } catch(std::logic_error& e) {
+            std::cerr << "ERROR: " << "The argument " << cacheToCacheEventString << " is invalid for option --c2c_event." << std::endl << std::endl;
+            std::cerr << *allOptions << std::endl;
+            exit(1);
+        }
+
         if (debugOutput)
             extendedOutput = true;
 
+        if (countAllocations)
+            allocationCountingEnabled = true;
+
+        placementOrder.clear();
+        if (placementPolicy != "none") {
+            try {
+                if (std::isdigit(placementPolicy[0])) {
+                    placementOrder = parseCPUList(placementPolicy);
+                } else {
+                    placementOrder = CPUTopology().order(placementPolicy);
+                }
+            } catch (std::logic_error& e) {}
+            if (placementOrder.empty()) {
+                std::cerr << "ERROR: " << "The argument " << placementPolicy << " is invalid for option --placement." << std::endl << std::endl;
+                std::cerr << *allOptions << std::endl;
+                exit(1);
+            }
+        }
+
+        if (clockSourceName == "tsc") {
+            if (!BenchmarkClock::invariantTSCAvailable()) std::cerr << "WARNING: " << "The TSC of this CPU is not invariant." << std::endl;
+            BenchmarkClock::select(BenchmarkClock::TSC);
+        } else if (clockSourceName == "chrono") {
+            BenchmarkClock::select(BenchmarkClock::CHRONO);
+        } else if (clockSourceName == "auto") {
+            BenchmarkClock::select(BenchmarkClock::invariantTSCAvailable() ? BenchmarkClock::TSC : BenchmarkClock::CHRONO);
+        } else {
+            std::cerr << "ERROR: " << "The argument " << clockSourceName << " is invalid for option --clock." << std::endl << std::endl;
+            std::cerr << *allOptions << std::endl;
+            exit(1);
+        }
+
+        if (arrivalProcessName == "closed") {
+            arrivalProcess = CLOSED;
+        } else if (arrivalProcessName == "constant") {
+            arrivalProcess = CONSTANT;
+        } else if (arrivalProcessName == "poisson") {
+            arrivalProcess = POISSON;
+        } else {
+            std::cerr << "ERROR: " << "The argument " << arrivalProcessName << " is invalid for option --arrival." << std::endl << std::endl;
+            std::cerr << *allOptions << std::endl;
+            exit(1);
+        }
+        if (arrivalProcess != CLOSED && offeredRate <= 0.0) {
+            std::cerr << "ERROR: " << "The argument " << offeredRate << " is invalid for option --rate." << std::endl << std::endl;
+            std::cerr << *allOptions << std::endl;
+            exit(1);
+        }
+        if (arrivalProcess == CLOSED && !sweepRates.empty()) {
+            std::cerr << "ERROR: " << "The option --sweep_rate requires an open-loop --arrival." << std::endl << std::endl;
+            std::cerr << *allOptions << std::endl;
+            exit(1);
+        }
+
+        antagonistSpecifications.clear();
+        antagonistsActive = false;
+        for (const std::string& antagonist : antagonistOptions) {
+            try {
+                antagonistSpecifications.push_back(parseAntagonist(antagonist));
+            } catch (std::logic_error& e) {
+                std::cerr << "ERROR: " << "The argument " << antagonist << " is invalid for option --antagonist." << std::endl << std::endl;
+                std::cerr << *allOptions << std::endl;
+                exit(1);
+            }
+        }
+
+        if (resultsFormat != "csv" && resultsFormat != "json") {
+            std::cerr << "ERROR: " << "The argument " << resultsFormat << " is invalid for option --results_format." << std::endl << std::endl;
+            std::cerr << *allOptions << std::endl;
+            exit(1);
+        }
+        if (!resultsFile.empty()) {
+            resultWriter = std::make_unique<ResultWriter>(resultsFile, resultsFormat == "csv" ? ResultWriter::CSV : ResultWriter::JSON);
+            if (!resultWriter->good()) {
+                std::cerr << "ERROR: " << "The results file " << resultsFile << " could not be opened." << std::endl;
+                exit(1);
+            }
+        }
+    }
+
+    std::vector<SweepDimension> sweepDimensions() {
+        std::vector<SweepDimension> dimensions;
+        if (!sweepThreads.empty()) {
+            dimensions.push_back({"threads", splitList(sweepThreads), [this](const std::string& value) {
+                threadCount = uint_fast32_t(std::stoul(value));
+                if (threadCount <= 0) throw std::invalid_argument(value);
+            }});
+        }
+        if (!sweepRates.empty()) {
+            dimensions.push_back({"rate", splitList(sweepRates), [this](const std::string& value) {
+                offeredRate = std::stod(value);
+                if (offeredRate <= 0.0) throw std::invalid_argument(value);
+            }});
+        }
+        for (SweepDimension& dimension : specificSweepDimensions()) {
+            if (!dimension.values.empty()) dimensions.push_back(dimension);
+        }
+        // The innermost dimension, so each cell with antagonists directly follows the same cell without them:
+        if (!antagonistSpecifications.empty()) {
+            dimensions.push_back({"antagonists", {"none", antagonistDescription()}, [this](const std::string& value) {
+                antagonistsActive = value != "none";
+            }});
+        }
+        return dimensions;
+    }
+
+    /// Advances to the next combination of the swept values (the last dimension varies fastest).
+    static bool nextCell(const std::vector<SweepDimension>& dimensions, std::vector<size_t>& cell) {
+        for (size_t d = dimensions.size(); d-- > 0;) {
+            if (++cell[d] < dimensions[d].values.size()) return true;
+            cell[d] = 0;
+        }
+        return false;
+    }
+
+    std::string antagonistDescription() {
+        std::ostringstream description;
+        for (const AntagonistSpecification& antagonist : antagonistSpecifications) {
+            description << (description.tellp() ? "," : "") << antagonistName(antagonist.type) << ":" << antagonist.count << ":" << antagonist.intensity;
+        }
+        return description.str();
+    }
+
+    /// The antagonists get placed on the CPUs following the ones of the worker threads.
+    std::vector<uint_fast32_t> antagonistPlacement() {
+        std::vector<uint_fast32_t> placement;
+        uint_fast32_t antagonistCount = 0;
+        for (const AntagonistSpecification& antagonist : antagonistSpecifications) antagonistCount += antagonist.count;
+        for (uint_fast32_t i = 0; i < antagonistCount && !placementOrder.empty(); i++) {
+            placement.push_back(placementOrder[(threadCount + i) % placementOrder.size()]);
+        }
+        return placement;
+    }
+
+    void placeThreads() {
+        threadPlacement.clear();
+        for (uint_fast32_t i = 0; i < threadCount && !placementOrder.empty(); i++) {
+            threadPlacement.push_back(placementOrder[i % placementOrder.size()]);
+        }
     }
 
 protected:
+    /// The specific parameters that can be swept (dimensions without values are ignored).
+    virtual std::vector<SweepDimension> specificSweepDimensions() {
+        return {};
+    };
+
     virtual void setSpecificConfig() {};
 
     virtual void initialize() {};
@@ -158,9 +476,27 @@ private:
 
             std::cout << "Configuration:" << std::endl;
             std::cout << "Threads: " << threadCount << std::endl;
+            std::cout << "Placement: " << placementPolicy;
+            for (uint_fast32_t i = 0; i < threadPlacement.size(); i++) {
+                std::cout << (i == 0 ? " (" : ", ") << "Thread " << i << " on CPU " << threadPlacement[i];
+            }
+            std::cout << (threadPlacement.empty() ? "" : ")") << std::endl;
             std::cout << "Iterations: " << iterationsCount << std::endl;
+            std::cout << "Warm-Up Iterations: " << warmUpIterationsCount << std::endl;
+            std::cout << "Arrival: " << arrivalProcessName;
+            if (arrivalProcess != CLOSED) std::cout << " (" << offeredRate << " Operations/s)";
+            std::cout << std::endl;
+            std::cout << "Antagonists: " << (antagonistsActive ? antagonistDescription() : "None") << std::endl;
             printSpecificConfigurationExtended();
             std::cout << "Timeout: " << std::chrono::nanoseconds(timeoutInNS) << std::endl;
+            if (BenchmarkClock::selected() == BenchmarkClock::TSC) {
+                std::cout << "Clock: TSC (" << BenchmarkClock::ticksPerNS() << " GHz)" << std::endl;
+            } else {
+                std::cout << "Clock: std::chrono::steady_clock" << std::endl;
+            }
+            std::cout << "Performance Counters: " << (collectCounters ? "Yes" : "No") << std::endl;
+            std::cout << "Allocation Counting: " << (countAllocations ? "Yes" : "No") << std::endl;
+            std::cout << "Sample Interval: " << (sampleIntervalInMS ? std::to_string(sampleIntervalInMS) + "ms" : "No Sampling") << std::endl;
             std::cout << "Debug: " << (debugOutput ? "Yes" : "No") << std::endl;
 
             for (int i = 1; i <= w.ws_col; i++)
@@ -169,6 +505,8 @@ private:
         } else {
             std::cout << threadCount << "\t" << iterationsCount;
             printSpecificConfiguration();
+            if (arrivalProcess != CLOSED) std::cout << "\t" << arrivalProcessName << "\t" << offeredRate;
+            if (!antagonistSpecifications.empty()) std::cout << "\t" << (antagonistsActive ? antagonistDescription() : "none");
         }
     }
 
@@ -178,17 +516,124 @@ protected:
     virtual void printSpecificConfigurationExtended() {};
 
 private:
+    void runCell() {
+        std::vector<ResultRecord> trials;
+        std::vector<double> times;
+        std::vector<bool> outliers;
+        while (trials.size() < trialCount || (confidenceIntervalWidth > 0.0 && trials.size() < maxTrialCount && !preciseEnough(times, outliers))) {
+            initialize();
+            printConfiguration();
+
+            runTimeoutThread();
+            runBenchmark();
+            stopTimeoutThread();
+
+            printResult(timeElapsed);
+            trials.push_back(resultRecord());
+            unInitialize();
+
+            times.push_back(double(timeElapsed));
+            outliers = outlierThreshold > 0.0 ? madOutliers(times, outlierThreshold) : std::vector<bool>(times.size(), false);
+        }
+
+        std::vector<ResultRecord> keptTrials;
+        for (size_t i = 0; i < trials.size(); i++) {
+            if (!outliers[i]) keptTrials.push_back(trials[i]);
+        }
+        ResultRecord summary = summarizeTrials(keptTrials);
+        summary.set("rejected_trials", double(trials.size() - keptTrials.size()));
+        if (trials.size() > 1) printTrialSummary(summary);
+
+        ResultRecord record = configurationRecord();
+        record.append(summary);
+        if (!antagonistSpecifications.empty()) addInterference(record);
+        cellRecords.push_back(record);
+        if (resultWriter) resultWriter->write(record);
+    }
+
+    /**\brief Adds the relative change of the throughput and of the tail latencies caused by the antagonists.
+     *
+     * The cell without antagonists is the previous one. For the cells
+     * without antagonists, the changes are undefined.
+     */
+    void addInterference(ResultRecord& record) {
+        const ResultRecord* baseline = antagonistsActive && !cellRecords.empty() ? &cellRecords.back() : nullptr;
+
+        std::vector<std::string> keys;
+        for (const ResultRecord::Field& field : record.fields()) {
+            if (field.numeric && (field.key == "operations_per_second" || field.key.find("_p99") != std::string::npos)) keys.push_back(field.key);
+        }
+
+        std::ostringstream changes;
+        for (const std::string& key : keys) {
+            double before, after;
+            double change = std::nan("");
+            if (baseline && baseline->get(key, before) && record.get(key, after) && before > 0.0) change = (after - before) / before;
+            record.set(key + "_change", change);
+
+            if (std::isnan(change)) continue;
+            if (extendedOutput) {
+                changes << (key == "operations_per_second" ? "Throughput" : key) << ": " << std::showpos << change * 100.0 << std::noshowpos << "%" << std::endl;
+            } else {
+                changes << "\t" << change;
+            }
+        }
+        if (!baseline) return;
+
+        if (extendedOutput) {
+            std::cout << "Interference by " << antagonistDescription() << ":" << std::endl << changes.str();
+        } else {
+            printConfiguration();
+            std::cout << "\t" << "interference" << changes.str() << std::endl;
+        }
+    }
+
+    bool preciseEnough(const std::vector<double>& times, const std::vector<bool>& outliers) {
+        std::vector<double> keptTimes;
+        for (size_t i = 0; i < times.size(); i++) {
+            if (!outliers[i]) keptTimes.push_back(times[i]);
+        }
+        Summary summary = summarize(keptTimes);
+        double halfWidth = confidenceInterval(summary, 0.95);
+        return !std::isnan(halfWidth) && 2.0 * halfWidth <= confidenceIntervalWidth * summary.mean;
+    }
+
     void runTimeoutThread() {
-        if (timeoutInNS)
+        if (timeoutInNS) {
+            timeoutCancelled = false;
             timeoutThread = new std::thread([&]{timeout();});
+        }
+    }
+
+    void stopTimeoutThread() {
+        if (timeoutInNS) {
+            {
+                std::lock_guard<std::mutex> lock(timeoutMutex);
+                timeoutCancelled = true;
+            }
+            timeoutCondition.notify_all();
+            timeoutThread->join();
+            delete timeoutThread;
+        }
+    }
+
+    /// In the open loop, the time it takes for the operations to arrive is added to the timeout.
+    uint_fast64_t timeoutDurationInNS() {
+        uint_fast64_t timeoutDuration = threadCount * (iterationsCount + warmUpIterationsCount) * timeoutInNS;
+        if (arrivalProcess != CLOSED) timeoutDuration += uint_fast64_t(operationCount() / offeredRate * 1000000000.0);
+        return timeoutDuration;
     }
 
     void timeout() {
-        std::this_thread::sleep_for(std::chrono::nanoseconds(threadCount * iterationsCount * timeoutInNS));
+        std::unique_lock<std::mutex> lock(timeoutMutex);
+        if (timeoutCondition.wait_for(lock, std::chrono::nanoseconds(timeoutDurationInNS()), [&]{return timeoutCancelled;})) {
+            return;
+        }
+
         if (extendedOutput) {
             std::cout << "##################################################################################################################" << std::endl
                       << "Results:" << std::endl
-                      << "Time Elapsed: " << "Timeout after " << std::chrono::nanoseconds(threadCount * iterationsCount * timeoutInNS) << "ns" << std::endl
+                      << "Time Elapsed: " << "Timeout after " << std::chrono::nanoseconds(timeoutDurationInNS()) << "ns" << std::endl
                       << "##################################################################################################################" << std::endl;
         } else {
             std::cout << "\t" << "timeout" << std::endl;
@@ -198,36 +643,211 @@ private:
 
     void runBenchmark() {
         threads = new std::thread*[threadCount]();
+        threadProgress = new ThreadProgress[threadCount]();
+        counterSample = PerformanceCounterSample();
+        allocationCounters = AllocationCounters();
+        peakHeapBytes = 0;
+        responseTime.reset();
+        timeline.clear();
+
+        std::unique_ptr<Antagonists> antagonists;
+        if (antagonistsActive) {
+            if (extendedOutput) std::cout << "Start antagonists " << antagonistDescription() << " ..." << std::endl;
+            antagonists = std::make_unique<Antagonists>(antagonistSpecifications, antagonistPlacement());
+        }
 
-        u_long start = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        // The spawning of the threads as well as before() and the warm-up are excluded from the timing:
+        startBarrier = std::make_unique<SpinBarrier>(threadCount + 1);
 
         if (extendedOutput) std::cout << "Start spawning " << threadCount << " threads ..." << std::endl;
         for (uint_fast32_t i = 0; i < threadCount; i++) {
-            threads[i] = new std::thread([&]{doWork([&]{work();}, [&]{before();}, [&]{after();});});
+            threads[i] = new std::thread([&, i]{runWorker(i, threadProgress[i]);});
         }
         if (extendedOutput) std::cout << "Finished spawning " << threadCount << " threads ..." << std::endl;
 
+        startBarrier->arriveAndWait();
+
+        if (sampleIntervalInMS || countAllocations) {
+            samplerRunning = true;
+            samplerThread = new std::thread([&]{sample();});
+        }
+
         if (extendedOutput) std::cout << "Waiting for " << threadCount << " threads to complete ..." << std::endl;
         for (uint_fast32_t i = 0; i < threadCount; i++) {
             threads[i]->join();
         }
         if (extendedOutput) std::cout << "All " << threadCount << " threads completed ..." << std::endl;
+        antagonists.reset();
 
-        timeElapsed = std::chrono::high_resolution_clock::now().time_since_epoch().count() - start;
+        if (sampleIntervalInMS || countAllocations) {
+            samplerRunning = false;
+            samplerThread->join();
+            delete samplerThread;
+        }
+
+        // Each thread takes its own start time as the main thread might not be scheduled right after the barrier:
+        uint_fast64_t start = UINT_FAST64_MAX;
+        for (uint_fast32_t i = 0; i < threadCount; i++) {
+            start = std::min(start, threadProgress[i].startTime);
+        }
+
+        timeElapsed = 0;
+        threadCompletionTimes.clear();
+        for (uint_fast32_t i = 0; i < threadCount; i++) {
+            uint_fast64_t completionTimeInNS = BenchmarkClock::toNanoseconds(threadProgress[i].completionTime - start);
+            timeElapsed = std::max(timeElapsed, completionTimeInNS);
+            threadCompletionTimes.push_back(double(completionTimeInNS));
+            delete threads[i];
+        }
+        delete[] threads;
+        delete[] threadProgress;
     }
 
-    void doWork(std::function<void()> workLoad, std::function<void()> before, std::function<void()> after) {
-        before();
-        for (uint_fast32_t i = 1; i <= iterationsCount; i++) {
+    /**\brief Samples the throughput timeline and the heap growth of the worker threads until they completed.
+     *
+     * The heap growth is the sum of the heap bytes of the threads, as one
+     * thread might free the blocks allocated by another one. Its peak is the
+     * maximum of the samples (the last one is taken after all the threads
+     * completed).
+     */
+    void sample() {
+        auto start = std::chrono::steady_clock::now();
+        auto nextSample = start;
+        uint_fast64_t lastOperations = 0;
+        auto lastSample = start;
+
+        while (true) {
+            nextSample += std::chrono::milliseconds(sampleIntervalInMS ? sampleIntervalInMS : 1);
+            std::this_thread::sleep_until(nextSample);
+            bool finalSample = !samplerRunning;
+
+            if (countAllocations) {
+                int_fast64_t heapBytes = 0;
+                for (uint_fast32_t i = 0; i < threadCount; i++) {
+                    heapBytes += threadProgress[i].heapBytes.load(std::memory_order_relaxed);
+                }
+                peakHeapBytes = std::max(peakHeapBytes, heapBytes);
+            }
+            if (!sampleIntervalInMS) {
+                if (finalSample) break;
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            uint_fast64_t operations = 0;
+            for (uint_fast32_t i = 0; i < threadCount; i++) {
+                operations += threadProgress[i].operations.load(std::memory_order_relaxed);
+            }
+
+            TimelineSample sample;
+            sample.timeInNS = std::chrono::nanoseconds(now - start).count();
+            sample.operations = operations - lastOperations;
+            sample.operationsPerSecond = double(sample.operations) / std::chrono::duration<double>(now - lastSample).count();
+            sample.specificAvailable = sampleSpecific(sample.specific);
+            timeline.push_back(sample);
+
+            lastOperations = operations;
+            lastSample = now;
+            if (finalSample) break;
+        }
+    }
+
+protected:
+    /**\brief Runs a worker thread, calling \c work() through a \c std::function for each operation.
+     *
+     * An evaluation can override this to call \c doWork() with a work load
+     * whose type is known at compile-time, so that the operation gets inlined
+     * into the measurement loop.
+     */
+    virtual void runWorker(uint_fast32_t threadIndex, ThreadProgress& progress) {
+        doWork(threadIndex, progress, std::function<void()>([this]{work();}));
+    }
+
+    template <typename WorkLoad>
+    void doWork(uint_fast32_t threadIndex, ThreadProgress& progress, WorkLoad workLoad) {
+        if (!threadPlacement.empty() && !pinThisThread(threadPlacement[threadIndex])) {
+            std::cerr << "WARNING: " << "Thread " << threadIndex << " could not be pinned to CPU " << threadPlacement[threadIndex] << "." << std::endl;
+        }
+
+        before(threadIndex);
+
+        for (uint_fast64_t i = 1; i <= warmUpIterationsCount; i++) {
             workLoad();
         }
+        afterWarmUp();
+
+        std::unique_ptr<ThreadPerformanceCounters> counters;
+        if (collectCounters) counters = std::make_unique<ThreadPerformanceCounters>(cacheToCacheEvent);
+
+        startBarrier->arriveAndWait();
+        progress.startTime = BenchmarkClock::now();
+
+        if (collectCounters) counters->start();
+        if (countAllocations) threadAllocationCounters = AllocationCounters();
+
+        progress.operations.store(0, std::memory_order_relaxed);
+        progress.heapBytes.store(0, std::memory_order_relaxed);
+        if (arrivalProcess == CLOSED) {
+            for (uint_fast32_t i = 1; i <= iterationsCount; i++) {
+                workLoad();
+                if (sampleIntervalInMS) progress.operations.store(i, std::memory_order_relaxed);
+                if (countAllocations) progress.heapBytes.store(threadAllocationCounters.heapBytes, std::memory_order_relaxed);
+            }
+        } else {
+            // Each thread gets an equal share of the offered load:
+            double meanInterArrivalTime = double(threadCount) * 1000000000.0 / offeredRate * BenchmarkClock::ticksPerNS();
+            std::mt19937_64 generator(std::random_device{}());
+            std::exponential_distribution<double> interArrivalTime(1.0 / meanInterArrivalTime);
+            LatencyHistogram threadResponseTime;
+
+            double arrival = double(progress.startTime);
+            for (uint_fast32_t i = 1; i <= iterationsCount; i++) {
+                arrival += arrivalProcess == POISSON ? interArrivalTime(generator) : meanInterArrivalTime;
+                uint_fast64_t scheduledArrival = uint_fast64_t(arrival);
+                while (BenchmarkClock::now() < scheduledArrival) {}
+
+                workLoad();
+                threadResponseTime.record(BenchmarkClock::toNanoseconds(BenchmarkClock::now() - scheduledArrival));
+                if (sampleIntervalInMS) progress.operations.store(i, std::memory_order_relaxed);
+                if (countAllocations) progress.heapBytes.store(threadAllocationCounters.heapBytes, std::memory_order_relaxed);
+            }
+
+            std::lock_guard<std::mutex> lock(responseTimeMutex);
+            responseTime.merge(threadResponseTime);
+        }
+        progress.completionTime = BenchmarkClock::now();
+
+        if (collectCounters) {
+            PerformanceCounterSample sample = counters->stop();
+            std::lock_guard<std::mutex> lock(counterSampleMutex);
+            counterSample.merge(sample);
+        }
+        if (countAllocations) {
+            AllocationCounters allocations = threadAllocationCounters;
+            std::lock_guard<std::mutex> lock(allocationCountersMutex);
+            allocationCounters.merge(allocations);
+        }
+
         after();
     }
 
 protected:
     virtual void work() {};
 
-    virtual void before() {};
+    /// Called by each worker thread after its warm-up iterations (even if there were none).
+    virtual void afterWarmUp() {};
+
+    /// A value sampled alongside the throughput timeline (e.g. the length of a data structure).
+    virtual bool sampleSpecific(int_fast64_t& value) {
+        return false;
+    };
+
+    virtual std::string sampleSpecificName() {
+        return "Specific";
+    };
+
+    /// Prepares the worker thread with the given index (in [0, threads)) before its first operation.
+    virtual void before(uint_fast32_t threadIndex) {};
 
     virtual void after() {};
 
@@ -243,19 +863,380 @@ private:
 
             std::cout << "Results:" << std::endl;
             std::cout << "Time Elapsed: " << std::chrono::nanoseconds(timeElapsed) << std::endl;
+            printResponseTimeExtended();
+            printCountersExtended();
+            printAllocationsExtended();
+            printFairnessExtended();
             printSpecificResultExtended();
+            if (timelineFile.empty()) printTimelineExtended();
 
             for (int i = 1; i <= w.ws_col; i++)
                 std::cout << "#";
             std::cout << std::endl;
         } else {
             std::cout << "\t" << timeElapsed;
+            printResponseTime();
+            printCounters();
+            printAllocations();
             printSpecificResult();
             std::cout << std::endl;
         }
+
+        if (!timelineFile.empty()) writeTimeline();
+    }
+
+    double operationCount() const {
+        return double(threadCount) * double(iterationsCount);
+    }
+
+    void printResponseTime() {
+        if (arrivalProcess == CLOSED) return;
+
+        std::cout << "\t" << responseTime.percentile(50.0)
+                  << "\t" << responseTime.percentile(99.0)
+                  << "\t" << responseTime.percentile(99.9)
+                  << "\t" << responseTime.max();
+    }
+
+    void printResponseTimeExtended() {
+        if (arrivalProcess == CLOSED) return;
+
+        std::cout << "Throughput: " << uint_fast64_t(timeElapsed ? operationCount() * 1000000000.0 / double(timeElapsed) : 0.0)
+                  << " Operations/s (offered " << offeredRate << " Operations/s)" << std::endl;
+        std::cout << "Response Time: " << responseTime.count() << " operations"
+                  << ", min " << responseTime.min() << "ns"
+                  << ", mean " << uint_fast64_t(responseTime.mean()) << "ns"
+                  << ", p50 " << responseTime.percentile(50.0) << "ns"
+                  << ", p90 " << responseTime.percentile(90.0) << "ns"
+                  << ", p99 " << responseTime.percentile(99.0) << "ns"
+                  << ", p99.9 " << responseTime.percentile(99.9) << "ns"
+                  << ", p99.99 " << responseTime.percentile(99.99) << "ns"
+                  << ", max " << responseTime.max() << "ns" << std::endl;
+    }
+
+    void printCounters() {
+        if (!collectCounters) return;
+
+        for (uint_fast32_t i = 0; i < PERFORMANCE_COUNTER_COUNT; i++) {
+            if (counterSample.available[i]) {
+                std::cout << "\t" << counterSample.values[i] / operationCount();
+            } else {
+                std::cout << "\t" << "n/a";
+            }
+        }
+        std::cout << "\t" << (counterSample.userTimeInS + counterSample.systemTimeInS) * 1000000000.0 / operationCount()
+                  << "\t" << counterSample.voluntaryContextSwitches / operationCount()
+                  << "\t" << counterSample.involuntaryContextSwitches / operationCount();
+    }
+
+    void printCountersExtended() {
+        if (!collectCounters) return;
+
+        for (uint_fast32_t i = 0; i < PERFORMANCE_COUNTER_COUNT; i++) {
+            std::cout << performanceCounterNames[i] << " per Operation: ";
+            if (counterSample.available[i]) {
+                std::cout << counterSample.values[i] / operationCount() << std::endl;
+            } else {
+                std::cout << "n/a" << std::endl;
+            }
+        }
+        if (counterSample.available[CYCLES] && counterSample.available[INSTRUCTIONS] && counterSample.values[CYCLES] > 0) {
+            std::cout << "Instructions per Cycle: " << counterSample.values[INSTRUCTIONS] / counterSample.values[CYCLES] << std::endl;
+        }
+        std::cout << "CPU Time per Operation: " << (counterSample.userTimeInS + counterSample.systemTimeInS) * 1000000000.0 / operationCount() << "ns"
+                  << " (User: " << counterSample.userTimeInS << "s, System: " << counterSample.systemTimeInS << "s)" << std::endl;
+        std::cout << "Context Switches per Operation: " << (counterSample.voluntaryContextSwitches + counterSample.involuntaryContextSwitches) / operationCount()
+                  << " (Voluntary: " << counterSample.voluntaryContextSwitches << ", Involuntary: " << counterSample.involuntaryContextSwitches << ")" << std::endl;
+    }
+
+    int_fast64_t peakHeapGrowth() const {
+        return peakHeapBytes;
+    }
+
+    void printAllocations() {
+        if (!countAllocations) return;
+
+        std::cout << "\t" << allocationCounters.allocations / operationCount()
+                  << "\t" << allocationCounters.deallocations / operationCount()
+                  << "\t" << allocationCounters.allocatedBytes / operationCount()
+                  << "\t" << peakHeapGrowth();
+    }
+
+    void printAllocationsExtended() {
+        if (!countAllocations) return;
+
+        std::cout << "Allocations per Operation: " << allocationCounters.allocations / operationCount()
+                  << " (" << allocationCounters.allocations << " Allocations, " << allocationCounters.allocatedBytes / operationCount() << " Bytes per Operation)" << std::endl;
+        std::cout << "Deallocations per Operation: " << allocationCounters.deallocations / operationCount()
+                  << " (" << allocationCounters.deallocations << " Deallocations)" << std::endl;
+        std::cout << "Peak Heap Growth: " << peakHeapGrowth() << " Bytes" << std::endl;
+    }
+
+    void printFairnessExtended() {
+        Summary completionTime = summarize(threadCompletionTimes);
+        std::cout << "Thread Completion Time: min " << std::chrono::nanoseconds(uint_fast64_t(completionTime.min))
+                  << ", max " << std::chrono::nanoseconds(uint_fast64_t(completionTime.max))
+                  << ", stddev " << std::chrono::nanoseconds(uint_fast64_t(completionTime.stddev)) << std::endl;
+
+        std::vector<double> threadThroughputs;
+        for (double completionTimeInNS : threadCompletionTimes) {
+            threadThroughputs.push_back(completionTimeInNS > 0 ? double(iterationsCount) / completionTimeInNS : 0.0);
+        }
+        std::cout << "Jain Fairness Index: " << jainFairnessIndex(threadThroughputs) << std::endl;
+    }
+
+    void printTimelineExtended() {
+        if (!sampleIntervalInMS) return;
+
+        std::cout << "Timeline:" << std::endl;
+        std::cout << "Time\tOperations\tOperations/s\t" << sampleSpecificName() << std::endl;
+        for (const TimelineSample& sample : timeline) {
+            std::cout << std::chrono::nanoseconds(sample.timeInNS) << "\t" << sample.operations << "\t" << uint_fast64_t(sample.operationsPerSecond) << "\t";
+            if (sample.specificAvailable) {
+                std::cout << sample.specific << std::endl;
+            } else {
+                std::cout << "n/a" << std::endl;
+            }
+        }
+    }
+
+    void writeTimeline() {
+        std::ofstream file(timelineFile);
+        if (!file) {
+            std::cerr << "ERROR: " << "The timeline file " << timelineFile << " could not be opened." << std::endl;
+            return;
+        }
+
+        file << "time_ns,operations,operations_per_second," << sampleSpecificName() << std::endl;
+        for (const TimelineSample& sample : timeline) {
+            file << sample.timeInNS << "," << sample.operations << "," << sample.operationsPerSecond << ",";
+            if (sample.specificAvailable) file << sample.specific;
+            file << std::endl;
+        }
+    }
+
+    ResultRecord configurationRecord() {
+        ResultRecord record;
+        record.set("evaluation", name);
+        record.set("threads", std::to_string(threadCount));
+        record.set("placement", placementPolicy);
+        record.set("iterations", std::to_string(iterationsCount));
+        record.set("warmup", std::to_string(warmUpIterationsCount));
+        record.set("clock", BenchmarkClock::selected() == BenchmarkClock::TSC ? "tsc" : "chrono");
+        record.set("arrival", arrivalProcessName);
+        record.set("rate", arrivalProcess != CLOSED ? formatNumber(offeredRate) : "");
+        record.set("antagonists", antagonistsActive ? antagonistDescription() : "none");
+        specificConfigurationRecord(record);
+        return record;
+    }
+
+    ResultRecord resultRecord() {
+        ResultRecord record;
+        record.set("time_elapsed_ns", double(timeElapsed));
+        record.set("operations_per_second", timeElapsed ? operationCount() * 1000000000.0 / double(timeElapsed) : 0.0);
+
+        if (arrivalProcess != CLOSED) {
+            record.set("response_time_mean_ns", responseTime.mean());
+            record.set("response_time_p50_ns", double(responseTime.percentile(50.0)));
+            record.set("response_time_p99_ns", double(responseTime.percentile(99.0)));
+            record.set("response_time_p99_9_ns", double(responseTime.percentile(99.9)));
+            record.set("response_time_max_ns", double(responseTime.max()));
+        }
+
+        if (collectCounters) {
+            for (uint_fast32_t i = 0; i < PERFORMANCE_COUNTER_COUNT; i++) {
+                if (counterSample.available[i]) record.set(recordKey(performanceCounterNames[i]) + "_per_operation", counterSample.values[i] / operationCount());
+            }
+            record.set("cpu_time_per_operation_ns", (counterSample.userTimeInS + counterSample.systemTimeInS) * 1000000000.0 / operationCount());
+            record.set("voluntary_context_switches_per_operation", counterSample.voluntaryContextSwitches / operationCount());
+            record.set("involuntary_context_switches_per_operation", counterSample.involuntaryContextSwitches / operationCount());
+        }
+
+        if (countAllocations) {
+            record.set("allocations_per_operation", allocationCounters.allocations / operationCount());
+            record.set("deallocations_per_operation", allocationCounters.deallocations / operationCount());
+            record.set("allocated_bytes_per_operation", allocationCounters.allocatedBytes / operationCount());
+            record.set("peak_heap_growth_bytes", double(peakHeapGrowth()));
+        }
+
+        std::vector<double> threadThroughputs;
+        for (double completionTimeInNS : threadCompletionTimes) {
+            threadThroughputs.push_back(completionTimeInNS > 0 ? double(iterationsCount) / completionTimeInNS : 0.0);
+        }
+        record.set("jain_fairness_index", jainFairnessIndex(threadThroughputs));
+
+        specificResultRecord(record);
+        return record;
+    }
+
+    void printTrialSummary(const ResultRecord& summary) {
+        double trials = 0.0, rejected = 0.0, medianTime = 0.0, meanTime = 0.0, halfWidth = std::nan(""), variation = std::nan("");
+        summary.get("trials", trials);
+        summary.get("rejected_trials", rejected);
+        summary.get("time_elapsed_ns_median", medianTime);
+        summary.get("time_elapsed_ns", meanTime);
+        summary.get("time_elapsed_ns_ci95", halfWidth);
+        summary.get("time_elapsed_ns_cv", variation);
+
+        if (extendedOutput) {
+            struct winsize w;
+            ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
+
+            for (int i = 1; i <= w.ws_col; i++)
+                std::cout << "#";
+            std::cout << std::endl;
+
+            std::cout << "Trial Summary:" << std::endl;
+            std::cout << "Trials: " << uint_fast64_t(trials) << " (" << uint_fast64_t(rejected) << " rejected as outliers)" << std::endl;
+            std::cout << "Time Elapsed (Median): " << std::chrono::nanoseconds(uint_fast64_t(medianTime)) << std::endl;
+            std::cout << "Time Elapsed (Mean): " << std::chrono::nanoseconds(uint_fast64_t(meanTime));
+            if (!std::isnan(halfWidth)) {
+                std::cout << " (95% CI: " << std::chrono::nanoseconds(uint_fast64_t(std::max(meanTime - halfWidth, 0.0)))
+                          << " to " << std::chrono::nanoseconds(uint_fast64_t(meanTime + halfWidth)) << ")";
+            }
+            std::cout << std::endl;
+            std::cout << "Coefficient of Variation: ";
+            if (std::isnan(variation)) {
+                std::cout << "n/a" << std::endl;
+            } else {
+                std::cout << variation * 100.0 << "%" << std::endl;
+            }
+
+            for (int i = 1; i <= w.ws_col; i++)
+                std::cout << "#";
+            std::cout << std::endl;
+        } else {
+            // The summary line has the configuration columns of the trial lines followed by "summary":
+            printConfiguration();
+            std::cout << "\t" << "summary"
+                      << "\t" << uint_fast64_t(medianTime)
+                      << "\t" << uint_fast64_t(meanTime)
+                      << "\t" << (std::isnan(halfWidth) ? "n/a" : std::to_string(uint_fast64_t(halfWidth)))
+                      << "\t" << (std::isnan(variation) ? "n/a" : std::to_string(variation))
+                      << "\t" << uint_fast64_t(trials)
+                      << "\t" << uint_fast64_t(rejected) << std::endl;
+        }
+    }
+
+    /// The mean of each result over the trials and the spread of the elapsed time.
+    ResultRecord summarizeTrials(const std::vector<ResultRecord>& trials) {
+        ResultRecord record;
+        record.set("trials", double(trials.size()));
+        for (const ResultRecord::Field& field : trials.front().fields()) {
+            if (!field.numeric) continue;
+
+            std::vector<double> values;
+            for (const ResultRecord& trial : trials) {
+                double value;
+                if (trial.get(field.key, value)) values.push_back(value);
+            }
+            Summary summary = summarize(values);
+            record.set(field.key, summary.mean);
+            if (field.key == "time_elapsed_ns") {
+                record.set("time_elapsed_ns_median", median(values));
+                record.set("time_elapsed_ns_stddev", summary.stddev);
+                record.set("time_elapsed_ns_min", summary.min);
+                record.set("time_elapsed_ns_max", summary.max);
+                record.set("time_elapsed_ns_ci95", confidenceInterval(summary, 0.95));
+                record.set("time_elapsed_ns_cv", summary.mean > 0.0 ? summary.stddev / summary.mean : std::nan(""));
+            }
+        }
+        return record;
+    }
+
+    /**\brief Compares the elapsed time of each cell with the matching record of the baseline.
+     *
+     * A record matches if all its configuration values are the same. A cell
+     * regressed if it got slower by more than the regression threshold and the
+     * difference is significant.
+     *
+     * \return 3 if a cell regressed, 2 if the baseline couldn't be read, 0 otherwise.
+     */
+    int compareWithBaseline(const std::vector<SweepDimension>& dimensions) {
+        std::vector<ResultRecord> baseline;
+        if (!readResultRecords(baselineFile, baseline)) {
+            std::cerr << "ERROR: " << "The baseline file " << baselineFile << " could not be read." << std::endl;
+            return 2;
+        }
+
+        auto timeSummary = [](const ResultRecord& record) {
+            Summary summary;
+            double trials = 1.0;
+            record.get("trials", trials);
+            summary.count = uint_fast64_t(trials);
+            record.get("time_elapsed_ns", summary.mean);
+            record.get("time_elapsed_ns_stddev", summary.stddev);
+            return summary;
+        };
+
+        bool regressed = false;
+        std::cout << std::endl << "Comparison with " << baselineFile << ":" << std::endl;
+        std::cout << "Configuration	Baseline [ns]	Current [ns]	Change	p-Value	Verdict" << std::endl;
+        for (const ResultRecord& cell : cellRecords) {
+            std::ostringstream configuration;
+            for (const SweepDimension& dimension : dimensions) {
+                configuration << (configuration.tellp() ? ", " : "") << dimension.name << "=" << cell.find(dimension.name)->value;
+            }
+            std::cout << (dimensions.empty() ? "-" : configuration.str()) << "	";
+
+            ResultRecord configurationFields = configurationRecord();
+            const ResultRecord* match = nullptr;
+            for (const ResultRecord& record : baseline) {
+                bool matches = true;
+                for (const ResultRecord::Field& field : configurationFields.fields()) {
+                    const ResultRecord::Field* value = record.find(field.key);
+                    if (!value || value->value != cell.find(field.key)->value) {
+                        matches = false;
+                        break;
+                    }
+                }
+                if (matches) {
+                    match = &record;
+                    break;
+                }
+            }
+            if (!match) {
+                std::cout << "n/a	" << uint_fast64_t(timeSummary(cell).mean) << "	n/a	n/a	not in baseline" << std::endl;
+                continue;
+            }
+
+            Summary before = timeSummary(*match);
+            Summary after = timeSummary(cell);
+            double change = before.mean > 0 ? (after.mean - before.mean) / before.mean : 0.0;
+            double pValue = welchTTest(before, after);
+            bool significant = !std::isnan(pValue) && pValue < significanceLevel;
+
+            std::cout << uint_fast64_t(before.mean) << "	" << uint_fast64_t(after.mean) << "	"
+                      << std::showpos << std::fixed << std::setprecision(2) << change * 100.0 << "%" << std::noshowpos << "	";
+            if (std::isnan(pValue)) {
+                std::cout << "n/a";
+            } else {
+                std::cout << std::setprecision(4) << pValue;
+            }
+            std::cout.unsetf(std::ios_base::floatfield);
+            std::cout << std::setprecision(6) << "	";
+
+            if (std::fabs(change) < regressionThreshold) {
+                std::cout << "unchanged" << std::endl;
+            } else if (!significant) {
+                std::cout << (std::isnan(pValue) ? "inconclusive (less than 2 trials)" : "not significant") << std::endl;
+            } else if (change > 0) {
+                std::cout << "REGRESSION" << std::endl;
+                regressed = true;
+            } else {
+                std::cout << "improvement" << std::endl;
+            }
+        }
+        return regressed ? 3 : 0;
     }
 
 protected:
+    /// Adds the specific configuration to a result record (as strings, as they identify the configuration).
+    virtual void specificConfigurationRecord(ResultRecord& record) {};
+
+    /// Adds the specific results of a trial to a result record (as numbers, as they get averaged over the trials).
+    virtual void specificResultRecord(ResultRecord& record) {};
+
     virtual void printSpecificResult() {};
 
     virtual void printSpecificResultExtended() {};
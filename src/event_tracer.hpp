@@ -0,0 +1,197 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_EVENT_TRACER_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_EVENT_TRACER_HPP
+
+#include <cstdint>
+
+/**\brief The events recorded by \c TRACE_EVENT.
+ *
+ * The numeric values are part of the binary trace format read by the
+ * trace_decoder and must therefore never be changed.
+ */
+enum class TraceEvent : uint8_t {
+    POP_SUCCESS = 0,
+    POP_FAILURE = 1,
+    REFILL_START = 2,
+    REFILL_STOP = 3,
+    ENQUEUE = 4
+};
+
+/// One record of the binary trace format (16 bytes).
+struct TraceRecord {
+    uint64_t    timestamp;      // TSC
+    uint32_t    pageID;
+    uint16_t    thread;
+    uint8_t     event;          // TraceEvent
+    uint8_t     reserved;
+};
+static_assert(sizeof(TraceRecord) == 16, "The binary trace format requires 16 byte records.");
+
+/**\brief The header of a trace file.
+ *
+ * It is followed by \c threadCount blocks, each consisting of a
+ * \c TraceThreadHeader and its \c recordCount \c TraceRecords in the order
+ * they were recorded.
+ */
+struct TraceFileHeader {
+    char        magic[4];       // "ZTRC"
+    uint16_t    version;
+    uint16_t    recordSize;
+    uint32_t    threadCount;
+    double      ticksPerNS;
+};
+
+struct TraceThreadHeader {
+    uint32_t    thread;
+    uint32_t    reserved;
+    uint64_t    recordCount;
+    uint64_t    droppedCount;
+};
+
+constexpr uint16_t traceFormatVersion = 1;
+
+#ifdef ZERO_EVALUATION_TRACING
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**\brief A per-thread ring buffer of trace records.
+ *
+ * Only its owning thread ever writes to the buffer and it's only read after
+ * that thread was joined, so recording doesn't need any synchronization. If
+ * the buffer overflows, the oldest records get overwritten.
+ */
+class TraceBuffer {
+public:
+    TraceBuffer(uint16_t thread, uint_fast64_t capacity) :
+            thread(thread),
+            mask(capacity - 1),
+            head(0),
+            records(new TraceRecord[capacity]) {}
+
+    inline void record(TraceEvent event, uint_fast64_t pageID) {
+        TraceRecord& record = records[head & mask];
+        record.timestamp = timestamp();
+        record.pageID = uint32_t(pageID);
+        record.thread = thread;
+        record.event = uint8_t(event);
+        record.reserved = 0;
+        head++;
+    }
+
+    static inline uint64_t timestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+private:
+    friend class EventTracer;
+
+    const uint16_t                  thread;
+    const uint_fast64_t             mask;
+    uint_fast64_t                   head;
+    std::unique_ptr<TraceRecord[]>  records;
+};
+
+/**\brief The registry of the per-thread trace buffers.
+ *
+ * A thread registers its buffer when it records its first event. The
+ * buffers are kept until the next \c start() so that they can be dumped
+ * after the worker threads terminated.
+ */
+class EventTracer {
+public:
+    static EventTracer& instance() {
+        static EventTracer tracer;
+        return tracer;
+    }
+
+    /// Discards all recorded events; \c recordsPerThread gets rounded up to a power of two.
+    void start(uint_fast64_t recordsPerThread) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.clear();
+        generation++;
+        capacity = 2;
+        while (capacity < recordsPerThread) capacity <<= 1;
+        startTimestamp = TraceBuffer::timestamp();
+        startTime = std::chrono::steady_clock::now();
+    }
+
+    inline TraceBuffer* buffer() {
+        thread_local TraceBuffer* threadBuffer = nullptr;
+        thread_local uint_fast64_t threadGeneration = 0;
+        if (threadGeneration != generation) {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            buffers.emplace_back(new TraceBuffer(uint16_t(buffers.size()), capacity));
+            threadBuffer = buffers.back().get();
+            threadGeneration = generation;
+        }
+        return threadBuffer;
+    }
+
+    /// Writes all the recorded events to the given file in the binary trace format.
+    bool dump(const std::string& fileName) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        std::FILE* file = std::fopen(fileName.c_str(), "wb");
+        if (!file) return false;
+
+        uint_fast64_t elapsedTicks = TraceBuffer::timestamp() - startTimestamp;
+        uint_fast64_t elapsedNS = std::chrono::nanoseconds(std::chrono::steady_clock::now() - startTime).count();
+
+        TraceFileHeader header;
+        std::memcpy(header.magic, "ZTRC", 4);
+        header.version = traceFormatVersion;
+        header.recordSize = sizeof(TraceRecord);
+        header.threadCount = uint32_t(buffers.size());
+        header.ticksPerNS = elapsedNS ? double(elapsedTicks) / double(elapsedNS) : 1.0;
+        std::fwrite(&header, sizeof(header), 1, file);
+
+        for (const std::unique_ptr<TraceBuffer>& buffer : buffers) {
+            uint_fast64_t capacity = buffer->mask + 1;
+            uint_fast64_t first = buffer->head > capacity ? buffer->head - capacity : 0;
+
+            TraceThreadHeader threadHeader;
+            threadHeader.thread = buffer->thread;
+            threadHeader.reserved = 0;
+            threadHeader.recordCount = buffer->head - first;
+            threadHeader.droppedCount = first;
+            std::fwrite(&threadHeader, sizeof(threadHeader), 1, file);
+
+            for (uint_fast64_t i = first; i < buffer->head; i++) {
+                std::fwrite(&buffer->records[i & buffer->mask], sizeof(TraceRecord), 1, file);
+            }
+        }
+        return std::fclose(file) == 0;
+    }
+
+private:
+    EventTracer() : generation(0), capacity(2) {}
+
+    std::mutex                                  buffersMutex;
+    std::vector<std::unique_ptr<TraceBuffer>>   buffers;
+    uint_fast64_t                               generation;
+    uint_fast64_t                               capacity;
+    uint64_t                                    startTimestamp;
+    std::chrono::steady_clock::time_point       startTime;
+};
+
+#define TRACE_EVENT(event, pageID) EventTracer::instance().buffer()->record(TraceEvent::event, (pageID))
+
+#else // ZERO_EVALUATION_TRACING
+
+#define TRACE_EVENT(event, pageID) do {} while (false)
+
+#endif // ZERO_EVALUATION_TRACING
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_EVENT_TRACER_HPP
@@ -4,34 +4,51 @@
 #include "free_list.hpp"
 #include "config.hpp"
 #include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
 
 #include <atomic>
 #include <boost/lockfree/queue.hpp>
 
-class BoostLockfreeQueueFixedSize : public FreeList {
+template <typename PageID = uint_fast32_t>
+class BoostLockfreeQueueFixedSize final : public FreeListOf<PageID> {
 private:
-    boost::lockfree::queue<uint_fast32_t, boost::lockfree::capacity<block_count - 1>>   _freelist;
-    std::atomic<uint_fast32_t>                                                          _approx_freelist_length;
+    boost::lockfree::queue<PageID, boost::lockfree::fixed_sized<true>>          _freelist;
+    std::atomic<uint_fast32_t>                                                  _approx_freelist_length;
+
+    // The nodes are addressed by 16 bit indices (one node is the dummy node):
+    static uint_fast32_t checkedCapacity() {
+        if (block_count - 1 > 65534) {
+            std::cerr << "ERROR: " << "boost::lockfree::queue_fixed_size supports at most 65535 blocks." << std::endl;
+            exit(1);
+        }
+        return block_count - 1;
+    };
 
 public:
-    BoostLockfreeQueueFixedSize() {
-        for (uint_fast32_t i = 1; i < block_count; i++) {
-            _freelist.push(i);
-            _approx_freelist_length++;
+    BoostLockfreeQueueFixedSize() : _freelist(checkedCapacity()) {};
+
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        for (uint_fast64_t i = first; i < last; i++) {
+            _freelist.push(pageIDs[i]);
         }
+        _approx_freelist_length += last - first;
     };
 
     // http://www.boost.org/doc/libs/1_63_0/doc/html/lockfree.html#lockfree.introduction___motivation.data_structure_configuration
-    void use(std::array<uint_fast32_t, block_count>& pageIDs, std::array<std::atomic_flag, block_count>& pageUnused) {
-        uint_fast32_t pageID;
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        PageID pageID;
         bool popSuccessful = _freelist.pop(pageID);
         if (popSuccessful) {
+            TRACE_EVENT(POP_SUCCESS, pageID);
             _approx_freelist_length--;
             if (debug) std::cout << _approx_freelist_length << std::endl;
             pageUnused[pageID].clear();
-            std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+            simulate_work();
             __asm__ __volatile__(""::"m" (pageID));
         } else {
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
             while (_approx_freelist_length < free_batch_size) {
                 pageID = fast_random();
                 if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
@@ -41,11 +58,35 @@ public:
                         _freelist.push(pageID);
                     }
                     _approx_freelist_length++;
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
                     if (debug) std::cout << _approx_freelist_length << std::endl;
                 }
             }
+            TRACE_EVENT(REFILL_STOP, 0);
+        }
+        return popSuccessful;
+    };
+
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        uint_fast32_t popped = 0;
+        while (popped < count && _freelist.pop(pageIDs[popped])) {
+            popped++;
+        }
+        _approx_freelist_length -= popped;
+        return popped;
+    };
+
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        for (uint_fast32_t i = 0; i < count; i++) {
+            _freelist.push(pageIDs[i]);
         }
+        _approx_freelist_length += count;
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _approx_freelist_length;
+        return true;
     };
 
 };
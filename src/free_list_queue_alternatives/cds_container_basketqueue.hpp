@@ -2,40 +2,54 @@
 #define ZERO_DETAILS_EVALUATION_CDS_CONTAINER_BASKETQUEUE_HPP
 
 #include "free_list.hpp"
+#include "cds_thread_context.hpp"
 #include "config.hpp"
 #include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
+#include "../pool_allocator.hpp"
 
 #include <atomic>
 #include <cds/opt/options.h>
 #include <cds/container/basket_queue.h>
 
-class CDSContainerBasketQueue : public FreeList {
+template <typename PageID = uint_fast32_t, typename Allocator = std::allocator<PageID>>
+class CDSContainerBasketQueue final : public FreeListOf<PageID> {
 private:
-    cds::container::BasketQueue<cds::gc::HP, uint_fast32_t>*    _freelist;
+    typedef cds::container::BasketQueue<cds::gc::HP, PageID,
+            typename cds::container::basket_queue::make_traits<cds::opt::allocator<Allocator>>::type> Queue;
+
+    Queue*                                                      _freelist;
     std::atomic<uint_fast32_t>                                  _approx_freelist_length;
 
 public:
     CDSContainerBasketQueue() {
         cds::threading::Manager::attachThread();
-        _freelist = new cds::container::BasketQueue<cds::gc::HP, uint_fast32_t>;
-        for (uint_fast32_t i = 1; i < block_count; i++) {
-            _freelist->enqueue(i);
-            _approx_freelist_length++;
-        }
+        _freelist = new Queue;
         cds::threading::Manager::detachThread();
     };
 
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        for (uint_fast64_t i = first; i < last; i++) {
+            _freelist->enqueue(pageIDs[i]);
+        }
+        _approx_freelist_length += last - first;
+    };
+
     // http://libcds.sourceforge.net/doc/cds-api/classcds_1_1container_1_1_basket_queue.html
-    void use(std::array<uint_fast32_t, block_count>& pageIDs, std::array<std::atomic_flag, block_count>& pageUnused) {
-        uint_fast32_t pageID;
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        PageID pageID;
         bool popSuccessful = _freelist->dequeue(pageID);
         if (popSuccessful) {
+            TRACE_EVENT(POP_SUCCESS, pageID);
             _approx_freelist_length--;
             if (debug) std::cout << _approx_freelist_length << std::endl;
             pageUnused[pageID].clear();
-            std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+            simulate_work();
             __asm__ __volatile__(""::"m" (pageID));
         } else {
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
             while (_approx_freelist_length < free_batch_size) {
                 pageID = fast_random();
                 if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
@@ -46,17 +60,41 @@ public:
                         _freelist->enqueue(pageID);
                         _approx_freelist_length++;
                     }
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
                     if (debug) std::cout << _approx_freelist_length << std::endl;
                 }
             }
+            TRACE_EVENT(REFILL_STOP, 0);
         }
+        return popSuccessful;
     };
 
-    bool useCDSThreadManagement() {
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        uint_fast32_t popped = 0;
+        while (popped < count && _freelist->dequeue(pageIDs[popped])) {
+            popped++;
+        }
+        _approx_freelist_length -= popped;
+        return popped;
+    };
+
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        for (uint_fast32_t i = 0; i < count; i++) {
+            _freelist->enqueue(pageIDs[i]);
+        }
+        _approx_freelist_length += count;
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _approx_freelist_length;
         return true;
     };
 
+    std::unique_ptr<FreeListContext> createContext() {
+        return std::make_unique<CDSThreadContext>();
+    };
+
 };
 
 #endif //ZERO_DETAILS_EVALUATION_CDS_CONTAINER_BASKETQUEUE_HPP
@@ -0,0 +1,20 @@
+#ifndef ZERO_DETAILS_EVALUATION_CDS_THREAD_CONTEXT_HPP
+#define ZERO_DETAILS_EVALUATION_CDS_THREAD_CONTEXT_HPP
+
+#include "free_list.hpp"
+
+#include <cds/init.h>
+
+/// Attaches the thread to the LibCDS thread management (e.g. for its hazard pointers) while it exists.
+class CDSThreadContext : public FreeListContext {
+public:
+    CDSThreadContext() {
+        cds::threading::Manager::attachThread();
+    };
+
+    ~CDSThreadContext() {
+        cds::threading::Manager::detachThread();
+    };
+};
+
+#endif //ZERO_DETAILS_EVALUATION_CDS_THREAD_CONTEXT_HPP
@@ -3,16 +3,46 @@
 
 // Options regarding benchmark execution:
 uint_fast32_t thread_count;
+uint_fast32_t init_thread_count = 1;
 uint_fast32_t iteration_count;
-const uint_fast32_t block_count = 6523;
+uint_fast32_t block_count = 6523;
+bool huge_pages = false;
 uint_fast32_t free_batch_size = 0;
 uint_fast64_t work_time_ns;
 uint_fast64_t timeout_ns;
 
+// Options regarding the simulated work:
+enum WorkModel {
+    SPIN,
+    READ,
+    WRITE,
+    SLEEP
+};
+WorkModel work_model = SPIN;
+uint_fast32_t work_bytes;
+
 // Options regarding implementation alternative:
 std::string queue;
 bool move;
 
+// Options regarding the sharded free list:
+enum StealPolicy {
+    RANDOM_VICTIM,
+    ROUND_ROBIN,
+    LARGEST_FIRST
+};
+uint_fast32_t shard_count = 0;      // 0 is one shard per thread
+StealPolicy steal_policy = RANDOM_VICTIM;
+
+// Options regarding the NUMA-aware free list:
+enum NUMAFallback {
+    NEAREST_NODE,
+    LARGEST_NODE,
+    LOCAL_ONLY
+};
+uint_fast32_t virtual_nodes = 0;    // 0 are the nodes of the machine
+NUMAFallback numa_fallback = NEAREST_NODE;
+
 // Options regarding output:
 bool extended_output;
 bool debug;
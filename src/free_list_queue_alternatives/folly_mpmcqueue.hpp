@@ -4,30 +4,38 @@
 #include "free_list.hpp"
 #include "config.hpp"
 #include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
 
 #include <folly/MPMCQueue.h>
 
-class FollyMPMCQueue : public FreeList {
+template <typename PageID = uint_fast32_t>
+class FollyMPMCQueue final : public FreeListOf<PageID> {
 private:
-    folly::MPMCQueue<uint_fast32_t> _freelist;
+    folly::MPMCQueue<PageID>        _freelist;
 
 public:
-    FollyMPMCQueue() : _freelist(block_count - 1) {
-        for (uint_fast32_t i = 1; i < block_count; i++) {
-            _freelist.writeIfNotFull(i);
+    FollyMPMCQueue() : _freelist(block_count - 1) {};
+
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        for (uint_fast64_t i = first; i < last; i++) {
+            _freelist.writeIfNotFull(pageIDs[i]);
         }
     };
 
     // https://github.com/facebook/folly
-    void use(std::array<uint_fast32_t, block_count>& pageIDs, std::array<std::atomic_flag, block_count>& pageUnused) {
-        uint_fast32_t pageID;
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        PageID pageID;
         bool popSuccessful = _freelist.readIfNotEmpty(pageID);
         if (popSuccessful) {
+            TRACE_EVENT(POP_SUCCESS, pageID);
             if (debug) std::cout << _freelist.sizeGuess() << std::endl;
             pageUnused[pageID].clear();
-            std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+            simulate_work();
             __asm__ __volatile__(""::"m" (pageID));
         } else {
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
             while (_freelist.sizeGuess() < free_batch_size) {
                 pageID = fast_random();
                 if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
@@ -41,13 +49,38 @@ public:
                         std::cerr << "There isn't enough memory allocated!" << std::endl;
                         exit(1);
                     }
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
                     if (debug) std::cout << _freelist.sizeGuess() << std::endl;
                 }
             }
+            TRACE_EVENT(REFILL_STOP, 0);
+        }
+        return popSuccessful;
+    };
+
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        uint_fast32_t popped = 0;
+        while (popped < count && _freelist.readIfNotEmpty(pageIDs[popped])) {
+            popped++;
+        }
+        return popped;
+    };
+
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        for (uint_fast32_t i = 0; i < count; i++) {
+            if (!_freelist.writeIfNotFull(pageIDs[i])) {
+                std::cerr << "There isn't enough memory allocated!" << std::endl;
+                exit(1);
+            }
         }
     };
 
+    bool approximateLength(int_fast64_t& length) {
+        length = _freelist.sizeGuess();
+        return true;
+    };
+
 };
 
 #endif //ZERO_DETAILS_EVALUATION_FOLLY_MPMCQUEUE_HPP
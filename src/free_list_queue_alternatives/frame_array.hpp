@@ -0,0 +1,84 @@
+#ifndef ZERO_DETAILS_EVALUATION_FRAME_ARRAY_HPP
+#define ZERO_DETAILS_EVALUATION_FRAME_ARRAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+
+/**\brief A zero-initialized array with one entry per buffer frame, sized at runtime.
+ *
+ * The memory is mapped anonymously. With huge pages, it's first tried to map
+ * explicit huge pages (\c MAP_HUGETLB, which requires reserved huge pages) and
+ * otherwise the kernel is advised to back the mapping with transparent huge
+ * pages. The entries have to be valid when all their bytes are zero (like
+ * unsigned integers and a cleared \c std::atomic_flag).
+ */
+template <typename T>
+class FrameArray {
+public:
+    FrameArray() : _frames(nullptr), _size(0), _bytes(0), _explicitHugePages(false) {};
+
+    FrameArray(const FrameArray&) = delete;
+    FrameArray& operator=(const FrameArray&) = delete;
+
+    ~FrameArray() {
+        release();
+    };
+
+    /// Replaces the entries by \c size zero-initialized ones.
+    void allocate(uint_fast64_t size, bool hugePages) {
+        release();
+        _size = size;
+        _bytes = (size * sizeof(T) + (2 << 20) - 1) / (2 << 20) * (2 << 20);
+        void* frames = MAP_FAILED;
+        if (hugePages) {
+            frames = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            _explicitHugePages = frames != MAP_FAILED;
+        }
+        if (frames == MAP_FAILED) {
+            frames = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (frames == MAP_FAILED) throw std::bad_alloc();
+            if (hugePages) madvise(frames, _bytes, MADV_HUGEPAGE);
+        }
+        _frames = static_cast<T*>(frames);
+    };
+
+    void release() {
+        if (_frames) munmap(_frames, _bytes);
+        _frames = nullptr;
+        _size = 0;
+        _bytes = 0;
+        _explicitHugePages = false;
+    };
+
+    inline T& operator[](uint_fast64_t index) {
+        return _frames[index];
+    };
+
+    inline const T& operator[](uint_fast64_t index) const {
+        return _frames[index];
+    };
+
+    uint_fast64_t size() const {
+        return _size;
+    };
+
+    /// The mapped bytes (rounded up to 2MiB).
+    uint_fast64_t bytes() const {
+        return _bytes;
+    };
+
+    /// Returns \c true if the entries are backed by explicit (not only transparent) huge pages.
+    bool explicitHugePages() const {
+        return _explicitHugePages;
+    };
+
+private:
+    T*              _frames;
+    uint_fast64_t   _size;
+    uint_fast64_t   _bytes;
+    bool            _explicitHugePages;
+};
+
+#endif //ZERO_DETAILS_EVALUATION_FRAME_ARRAY_HPP
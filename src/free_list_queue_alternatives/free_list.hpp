@@ -2,16 +2,84 @@
 #define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_FREE_LIST_HPP
 
 #include "config.hpp"
+#include "frame_array.hpp"
 
+#include <memory>
+
+/**\brief The state a thread keeps for a free list (e.g. its producer and consumer tokens).
+ *
+ * A context is created by each thread before its first operation on a free
+ * list and destroyed after its last one. Free lists needing per-thread state
+ * derive their own context from it and cast the one passed to \c use().
+ */
+class FreeListContext {
+public:
+    virtual ~FreeListContext() {};
+};
+
+/**\brief The part of a free list that doesn't depend on the type of its page IDs.
+ */
 class FreeList {
 public:
-    virtual void use(std::array<uint_fast32_t, block_count>& pageIDs, std::array<std::atomic_flag, block_count>& pageUnused) {};
+    virtual ~FreeList() {};
+
+    /// Creates the context of the calling thread.
+    virtual std::unique_ptr<FreeListContext> createContext() {
+        return std::make_unique<FreeListContext>();
+    };
+
+    /// Creates the context of the worker thread with the given index (the fill threads use \c createContext()).
+    virtual std::unique_ptr<FreeListContext> createWorkerContext(uint_fast32_t threadIndex) {
+        return createContext();
+    };
+
+    /// Returns \c false if the free list can't report its (approximate) length.
+    virtual bool approximateLength(int_fast64_t& length) {
+        return false;
+    };
+
+    /// The bytes of the free list which aren't allocated through operator new (e.g. mapped arrays).
+    virtual uint_fast64_t unallocatedBytes() {
+        return 0;
+    };
+};
+
+/**\brief A free list storing page IDs of the given type.
+ *
+ * The smaller the type of the page IDs, the smaller the footprint of the
+ * buffers and nodes of the free list. IDs of \c uint16_t only support up to
+ * 65536 blocks.
+ */
+template <typename PageID>
+class FreeListOf : public FreeList {
+public:
+    typedef PageID page_id_type;
+
+    /**\brief Adds the entries <tt>[first, last)</tt> of the \c length page IDs to the free list.
+     *
+     * The free list is constructed empty and filled by one or more threads,
+     * each with its own context and a disjoint range of the page IDs. Free
+     * lists offering bulk operations (or direct access to their buffer) use
+     * them here instead of single enqueues. The page IDs might be mapped from
+     * a snapshot.
+     */
+    virtual void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {};
+
+    /// Called once the free list got filled with all the \c length page IDs (e.g. to publish them).
+    virtual void init(const PageID* pageIDs, uint_fast64_t length) {};
+
+    /// Pops up to \c count page IDs into \c pageIDs and returns the number of popped ones.
+    virtual uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        return 0;
+    };
 
-    virtual void init() {};
+    /// Pushes the \c count page IDs (natively as a batch if the free list supports it).
+    virtual void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {};
 
-    virtual bool useCDSThreadManagement() {
+    /// Returns \c true if a free page was popped right away and \c false if the refill path was taken.
+    virtual bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
         return false;
-    }
+    };
 };
 
 #endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_FREE_LIST_HPP
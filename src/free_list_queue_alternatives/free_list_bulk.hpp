@@ -0,0 +1,55 @@
+#ifndef ZERO_DETAILS_EVALUATION_FREE_LIST_BULK_HPP
+#define ZERO_DETAILS_EVALUATION_FREE_LIST_BULK_HPP
+
+#include "free_list.hpp"
+#include "config.hpp"
+#include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
+
+/**\brief The operation of \c FreeListOf::use() with batches of \c batchSize page IDs.
+ *
+ * Up to \c batchSize free pages are popped at once (like the frames of a scan
+ * or of a read-ahead). If none could be popped, the free list is refilled up
+ * to \c free_batch_size pages and the victims are pushed whenever
+ * \c batchSize of them are collected. The free list is passed as its concrete
+ * type, so the calls of \c popBulk() and \c pushBulk() aren't virtual.
+ *
+ * @return \c true if free pages were popped right away and \c false if the refill path was taken.
+ */
+template <typename Queue, typename PageID = typename Queue::page_id_type>
+inline bool useBulk(Queue& freeList, FreeListContext& context, FrameArray<std::atomic_flag>& pageUnused, PageID* batch, uint_fast32_t batchSize) {
+    uint_fast32_t popped = freeList.popBulk(context, batch, batchSize);
+    if (popped > 0) {
+        for (uint_fast32_t i = 0; i < popped; i++) {
+            TRACE_EVENT(POP_SUCCESS, batch[i]);
+            pageUnused[batch[i]].clear();
+            simulate_work();
+        }
+        __asm__ __volatile__(""::"m" (*batch));
+        return true;
+    } else {
+        TRACE_EVENT(POP_FAILURE, 0);
+        TRACE_EVENT(REFILL_START, 0);
+        uint_fast32_t collected = 0;
+        int_fast64_t length;
+        while (freeList.approximateLength(length) && length + int_fast64_t(collected) < int_fast64_t(free_batch_size)) {
+            PageID pageID = fast_random();
+            if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
+                batch[collected++] = pageID;
+                TRACE_EVENT(ENQUEUE, pageID);
+                simulate_work();
+                if (collected == batchSize) {
+                    freeList.pushBulk(context, batch, collected);
+                    collected = 0;
+                    if (debug && freeList.approximateLength(length)) std::cout << length << std::endl;
+                }
+            }
+        }
+        if (collected > 0) freeList.pushBulk(context, batch, collected);
+        TRACE_EVENT(REFILL_STOP, 0);
+        return false;
+    }
+}
+
+#endif //ZERO_DETAILS_EVALUATION_FREE_LIST_BULK_HPP
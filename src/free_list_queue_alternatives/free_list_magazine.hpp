@@ -0,0 +1,98 @@
+#ifndef ZERO_DETAILS_EVALUATION_FREE_LIST_MAGAZINE_HPP
+#define ZERO_DETAILS_EVALUATION_FREE_LIST_MAGAZINE_HPP
+
+#include "free_list.hpp"
+#include "config.hpp"
+#include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+/**\brief A small thread-local cache of free pages in front of a free list.
+ *
+ * Like the magazines (or tcache) of allocators, a thread pops from its own
+ * magazine and only accesses the free list to reload the empty magazine with
+ * up to \c size pages or to flush half of the full magazine. The pages in the
+ * magazines can't be used by the other threads.
+ */
+template <typename PageID>
+struct Magazine {
+    std::vector<PageID>     pageIDs;
+    uint_fast32_t           count = 0;
+    uint_fast64_t           hits = 0;       // pops served by the magazine
+    uint_fast64_t           misses = 0;     // pops which had to reload the magazine
+
+    void resize(uint_fast32_t size) {
+        pageIDs.resize(size);
+        count = 0;
+        hits = 0;
+        misses = 0;
+    };
+
+    uint_fast32_t size() const {
+        return uint_fast32_t(pageIDs.size());
+    };
+};
+
+/**\brief The operation of \c FreeListOf::use() through the \c Magazine of the thread.
+ *
+ * A pop is served by the magazine if it contains pages. Otherwise, the
+ * magazine is reloaded using \c popBulk(). If the free list is empty as well,
+ * the free list is refilled up to \c free_batch_size pages (including the ones
+ * in the magazine). The victims are put into the magazine and half of the
+ * magazine is flushed using \c pushBulk() whenever it is full. The free list
+ * is passed as its concrete type, so these calls aren't virtual.
+ *
+ * @return \c true if a free page was popped and \c false if the refill path was taken.
+ */
+template <typename Queue, typename PageID = typename Queue::page_id_type>
+inline bool useMagazine(Queue& freeList, FreeListContext& context, FrameArray<std::atomic_flag>& pageUnused, Magazine<PageID>& magazine) {
+    if (magazine.count > 0) {
+        magazine.hits++;
+    } else {
+        magazine.misses++;
+        magazine.count = freeList.popBulk(context, magazine.pageIDs.data(), magazine.size());
+    }
+    if (magazine.count > 0) {
+        PageID pageID = magazine.pageIDs[--magazine.count];
+        TRACE_EVENT(POP_SUCCESS, pageID);
+        pageUnused[pageID].clear();
+        simulate_work();
+        __asm__ __volatile__(""::"m" (pageID));
+        return true;
+    } else {
+        TRACE_EVENT(POP_FAILURE, 0);
+        TRACE_EVENT(REFILL_START, 0);
+        int_fast64_t length;
+        while (freeList.approximateLength(length) && length + int_fast64_t(magazine.count) < int_fast64_t(free_batch_size)) {
+            PageID pageID = fast_random();
+            if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
+                if (magazine.count == magazine.size()) {
+                    // The older half of the magazine is flushed:
+                    uint_fast32_t flushed = std::max(uint_fast32_t(1), magazine.count / 2);
+                    freeList.pushBulk(context, magazine.pageIDs.data(), flushed);
+                    std::memmove(magazine.pageIDs.data(), magazine.pageIDs.data() + flushed, (magazine.count - flushed) * sizeof(PageID));
+                    magazine.count -= flushed;
+                    if (debug && freeList.approximateLength(length)) std::cout << length << std::endl;
+                }
+                magazine.pageIDs[magazine.count++] = pageID;
+                TRACE_EVENT(ENQUEUE, pageID);
+                simulate_work();
+            }
+        }
+        TRACE_EVENT(REFILL_STOP, 0);
+        return false;
+    }
+}
+
+/// Returns the pages of the magazine to the free list (e.g. when its thread terminates).
+template <typename PageID>
+inline void flushMagazine(FreeListOf<PageID>& freeList, FreeListContext& context, Magazine<PageID>& magazine) {
+    if (magazine.count > 0) freeList.pushBulk(context, magazine.pageIDs.data(), magazine.count);
+    magazine.count = 0;
+}
+
+#endif //ZERO_DETAILS_EVALUATION_FREE_LIST_MAGAZINE_HPP
@@ -4,10 +4,21 @@
 #include <cds/init.h>
 #include <cds/gc/hp.h>
 
+thread_local LatencyHistogram threadPopLatency;
+thread_local LatencyHistogram threadRefillLatency;
+thread_local ThreadStatistics threadStatistic;
+thread_local std::unique_ptr<FreeListContext> threadContext;
+template <typename PageID>
+thread_local std::vector<PageID> threadBatch;
+template <typename PageID>
+thread_local Magazine<PageID> threadMagazine;
+
 void FreeListQueueAlternatives::setSpecificOptions() {
     specificOptions->add_options()
-            ("free_batch,f", po::value<uint_fast32_t>(&freeBatchSize)->default_value(0.1 * block_count)->notifier([](uint_fast32_t value) { if (value <= 0 || value > block_count) {throw po::invalid_option_value(std::to_string(value));}}), "Number of blocks freed at once.")
-            ("queue,q", po::value<std::string>(&useQueue)->required(), "Used concurrent queue/stack.\n"
+            ("blocks,b", po::value<uint_fast32_t>(&blockCount)->default_value(block_count)->notifier([](uint_fast32_t value) { if (value < 2) {throw po::invalid_option_value(std::to_string(value));}}), "Number of blocks (buffer frames) of the simulated buffer pool.")
+            ("huge_pages", po::bool_switch(&useHugePages)->default_value(false), "Back the per-block arrays with huge pages (explicit ones if reserved, transparent ones otherwise).")
+            ("free_batch,f", po::value<uint_fast32_t>(&freeBatchSize)->default_value(0, "10% of --blocks"), "Number of blocks freed at once.")
+            ("queue,q", po::value<std::string>(&useQueue)->default_value(""), "Used concurrent queue/stack (required unless --sweep_queue is set).\n"
                     "Possible values:\n"
                     "- boost::lockfree::queue\n"
                     "- boost::lockfree::queue_fixed_size\n"
@@ -21,117 +32,784 @@ void FreeListQueueAlternatives::setSpecificOptions() {
                     "- cds::container::VyukovMPMCCycleQueue\n"
                     "- folly::MPMCQueue\n"
                     "- legacy\n"
+                    "- legacy_lockfree (the stack of legacy as a lock-free Treiber stack)\n"
                     "- lockfree_queue::mpmc_fixed_bounded_value\n"
                     "- moodycamel::ConcurrentQueue\n"
                     "- mpmc_bounded_queue\n"
                     "- mpmc_bounded_queue_t\n"
+                    "- numa (a stack per NUMA node preferring the frames of the own node)\n"
                     "- rigtorp::MPMCQueue\n"
+                    "- sharded (a stack per thread with work stealing)\n"
                     "- tbb::concurrent_bounded_queue\n"
                     "- tbb::concurrent_queue")
+            ("page_id", po::value<std::string>(&pageIDName)->default_value("uint_fast32"), "Type of the page IDs stored in the free list.\n"
+                    "Possible values:\n"
+                    "- uint16 (at most 65536 blocks)\n"
+                    "- uint32\n"
+                    "- uint_fast32 (the type of the original free lists)")
+            ("init_threads", po::value<uint_fast32_t>(&initThreadCount)->default_value(1)->notifier([](uint_fast32_t value) { if (value <= 0) {throw po::invalid_option_value(std::to_string(value));}}), "Number of threads filling the free list on startup.")
+            ("startup", po::value<std::string>(&startupName)->default_value("cold"), "How the free list and the frame states are initialized.\n"
+                    "Possible values:\n"
+                    "- cold (all the blocks are free)\n"
+                    "- restore (from the snapshot file)")
+            ("snapshot", po::value<std::string>(&snapshotFile)->default_value(""), "Snapshot file of the free list and the frame states written after each cold startup (and read by --startup restore).")
+            ("bulk_size", po::value<uint_fast32_t>(&bulkSize)->default_value(1)->notifier([](uint_fast32_t value) { if (value <= 0) {throw po::invalid_option_value(std::to_string(value));}}), "Number of pages popped at once and of victims pushed at once by popBulk and pushBulk (1 uses the single-page operation).")
+            ("magazine_size", po::value<uint_fast32_t>(&magazineSize)->default_value(0), "Number of pages cached in the magazine of each thread, which is reloaded from and flushed to the free list in bulks (0 disables the magazines, overrides --bulk_size).")
+            ("shards", po::value<uint_fast32_t>(&shardCount)->default_value(0), "Number of shards of the sharded free list (0 is one per thread).")
+            ("steal", po::value<std::string>(&stealPolicyName)->default_value("random"), "Shard the sharded free list steals from if the shard of a thread is empty.\n"
+                    "Possible values:\n"
+                    "- random (a random other shard)\n"
+                    "- round_robin (the other shards in turn)\n"
+                    "- largest (the other shard with the most pages)")
+            ("virtual_nodes", po::value<uint_fast32_t>(&virtualNodeCount)->default_value(0), "Number of virtual NUMA nodes the CPUs and frames are split into by the NUMA-aware free list (0 uses the nodes of the machine).")
+            ("numa_fallback", po::value<std::string>(&numaFallbackName)->default_value("nearest"), "What the NUMA-aware free list does if the partition of the node of a thread is empty.\n"
+                    "Possible values:\n"
+                    "- nearest (pop a frame of the nearest node with free frames)\n"
+                    "- largest (pop a frame of the node with the most free frames)\n"
+                    "- local_only (refill the partition with frames of the own node)")
+            ("allocator", po::value<std::string>(&useAllocator)->default_value("default"), "Allocator of the nodes of boost::lockfree::queue, cds::container::BasketQueue, cds::container::MSQueue and tbb::concurrent_queue (ignored by the other queues).\n"
+                    "Possible values:\n"
+                    "- default (the one of the container)\n"
+                    "- pool (per-thread size-class pool)")
             ("move,m", po::bool_switch(&useMove)->default_value(false), "Use std::move on enqueue.")
-            ("work,w", po::value<uint_fast64_t>(&workTimeInNS)->default_value(0), "Work time between iterations.");
+            ("dispatch", po::value<std::string>(&dispatchName)->default_value("static"), "How the worker loop calls the free list.\n"
+                    "Possible values:\n"
+                    "- static (a worker loop per free list type with the operation inlined)\n"
+                    "- virtual (a std::function and two virtual calls per operation)")
+            ("work,w", po::value<uint_fast64_t>(&workTimeInNS)->default_value(0), "Work time between iterations.")
+            ("work_model", po::value<std::string>(&workModelName)->default_value("spin"), "How the work time is spent.\n"
+                    "Possible values:\n"
+                    "- spin (busy-waiting on the calibrated clock)\n"
+                    "- read (reading --work_bytes of a page, then spinning)\n"
+                    "- write (writing --work_bytes of a page, then spinning)\n"
+                    "- sleep (std::this_thread::sleep_for)")
+            ("work_bytes", po::value<uint_fast32_t>(&workBytes)->default_value(work_page_size)->notifier([](uint_fast32_t value) { if (value > work_page_size) {throw po::invalid_option_value(std::to_string(value));}}), "Number of bytes of a page read or written by the read and write work models.")
+            ("latency,l", po::bool_switch(&recordLatency)->default_value(false), "Record per-thread latency histograms of the pop path and of the refill path.")
+            ("fairness", po::bool_switch(&recordThreadStatistics)->default_value(false), "Record the successful pops, the refills and the longest call of each thread and report their spread across the threads.")
+            ("sweep_queue", po::value<std::string>(&sweepQueues)->default_value(""), "Comma-separated concurrent queues/stacks to sweep over (overrides --queue).")
+            ("sweep_allocator", po::value<std::string>(&sweepAllocators)->default_value(""), "Comma-separated allocators to sweep over (overrides --allocator).")
+            ("sweep_page_id", po::value<std::string>(&sweepPageIDs)->default_value(""), "Comma-separated page ID types to sweep over (overrides --page_id).")
+            ("sweep_init_threads", po::value<std::string>(&sweepInitThreadCounts)->default_value(""), "Comma-separated numbers of threads filling the free list to sweep over (overrides --init_threads).")
+            ("sweep_startup", po::value<std::string>(&sweepStartups)->default_value(""), "Comma-separated startups to sweep over (overrides --startup).")
+            ("sweep_bulk_size", po::value<std::string>(&sweepBulkSizes)->default_value(""), "Comma-separated bulk sizes to sweep over (overrides --bulk_size).")
+            ("sweep_magazine_size", po::value<std::string>(&sweepMagazineSizes)->default_value(""), "Comma-separated magazine sizes to sweep over (overrides --magazine_size).")
+            ("sweep_shards", po::value<std::string>(&sweepShardCounts)->default_value(""), "Comma-separated numbers of shards to sweep over (overrides --shards).")
+            ("sweep_steal", po::value<std::string>(&sweepStealPolicies)->default_value(""), "Comma-separated steal policies to sweep over (overrides --steal).")
+            ("sweep_virtual_nodes", po::value<std::string>(&sweepVirtualNodeCounts)->default_value(""), "Comma-separated numbers of virtual NUMA nodes to sweep over (overrides --virtual_nodes).")
+            ("sweep_numa_fallback", po::value<std::string>(&sweepNUMAFallbacks)->default_value(""), "Comma-separated NUMA fallback policies to sweep over (overrides --numa_fallback).")
+            ("sweep_blocks", po::value<std::string>(&sweepBlockCounts)->default_value(""), "Comma-separated numbers of blocks to sweep over (overrides --blocks).")
+            ("sweep_free_batch", po::value<std::string>(&sweepFreeBatchSizes)->default_value(""), "Comma-separated numbers of blocks freed at once to sweep over (overrides --free_batch).")
+            ("sweep_work", po::value<std::string>(&sweepWorkTimes)->default_value(""), "Comma-separated work times to sweep over (overrides --work).");
+#ifdef ZERO_EVALUATION_TRACING
+    specificOptions->add_options()
+            ("trace_file", po::value<std::string>(&traceFile)->default_value("free_list.trace"), "File the binary event trace gets written to (decode it using trace_decoder).")
+            ("trace_buffer", po::value<uint_fast64_t>(&traceBufferSize)->default_value(1 << 20), "Number of events kept per thread (only the most recent ones are kept).");
+#endif // ZERO_EVALUATION_TRACING
+}
+
+std::vector<SweepDimension> FreeListQueueAlternatives::specificSweepDimensions() {
+    return {
+        {"queue", splitList(sweepQueues), [this](const std::string& value) {
+            useQueue = value;
+        }},
+        {"allocator", splitList(sweepAllocators), [this](const std::string& value) {
+            if (value != "default" && value != "pool") throw std::invalid_argument(value);
+            useAllocator = value;
+        }},
+        {"page_id", splitList(sweepPageIDs), [this](const std::string& value) {
+            if (value != "uint16" && value != "uint32" && value != "uint_fast32") throw std::invalid_argument(value);
+            pageIDName = value;
+        }},
+        {"init_threads", splitList(sweepInitThreadCounts), [this](const std::string& value) {
+            initThreadCount = uint_fast32_t(std::stoull(value));
+            if (initThreadCount < 1) throw std::out_of_range(value);
+        }},
+        {"bulk_size", splitList(sweepBulkSizes), [this](const std::string& value) {
+            bulkSize = uint_fast32_t(std::stoull(value));
+            if (bulkSize < 1) throw std::out_of_range(value);
+        }},
+        {"magazine_size", splitList(sweepMagazineSizes), [this](const std::string& value) {
+            magazineSize = uint_fast32_t(std::stoull(value));
+        }},
+        {"shards", splitList(sweepShardCounts), [this](const std::string& value) {
+            shardCount = uint_fast32_t(std::stoull(value));
+        }},
+        {"steal", splitList(sweepStealPolicies), [this](const std::string& value) {
+            if (value != "random" && value != "round_robin" && value != "largest") throw std::invalid_argument(value);
+            stealPolicyName = value;
+        }},
+        {"virtual_nodes", splitList(sweepVirtualNodeCounts), [this](const std::string& value) {
+            virtualNodeCount = uint_fast32_t(std::stoull(value));
+        }},
+        {"numa_fallback", splitList(sweepNUMAFallbacks), [this](const std::string& value) {
+            if (value != "nearest" && value != "largest" && value != "local_only") throw std::invalid_argument(value);
+            numaFallbackName = value;
+        }},
+        {"blocks", splitList(sweepBlockCounts), [this](const std::string& value) {
+            blockCount = uint_fast32_t(std::stoull(value));
+            if (blockCount < 2) throw std::out_of_range(value);
+        }},
+        {"free_batch", splitList(sweepFreeBatchSizes), [this](const std::string& value) {
+            freeBatchSize = uint_fast32_t(std::stoul(value));
+            if (freeBatchSize <= 0) throw std::out_of_range(value);
+        }},
+        {"work", splitList(sweepWorkTimes), [this](const std::string& value) {
+            workTimeInNS = std::stoull(value);
+        }},
+        // The innermost dimension, so a restore directly follows the cold startup writing its snapshot:
+        {"startup", splitList(sweepStartups), [this](const std::string& value) {
+            if (value != "cold" && value != "restore") throw std::invalid_argument(value);
+            startupName = value;
+        }}
+    };
 }
 
 void FreeListQueueAlternatives::setSpecificConfig() {
+    if (useQueue.empty()) {
+        std::cerr << "ERROR: " << "the option '--queue' is required but missing" << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+
+    if (pageIDName == "uint16") {
+        pageIDSize = sizeof(uint16_t);
+    } else if (pageIDName == "uint32") {
+        pageIDSize = sizeof(uint32_t);
+    } else if (pageIDName == "uint_fast32") {
+        pageIDSize = sizeof(uint_fast32_t);
+    } else {
+        std::cerr << "ERROR: " << "The argument " << pageIDName << " is invalid for option --page_id." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+    if (pageIDSize < sizeof(uint_fast32_t) && blockCount - 1 > (uint_fast64_t(1) << (8 * pageIDSize)) - 1) {
+        std::cerr << "ERROR: " << "The page IDs of type " << pageIDName << " can't identify " << blockCount << " blocks." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+    if (useQueue == "legacy_lockfree" && blockCount - 1 > UINT32_MAX) {
+        std::cerr << "ERROR: " << "The free list legacy_lockfree can't identify " << blockCount << " blocks (its page IDs are limited to 32 bits)." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+
+    if (startupName != "cold" && startupName != "restore") {
+        std::cerr << "ERROR: " << "The argument " << startupName << " is invalid for option --startup." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+    if (startupName == "restore" && snapshotFile.empty()) {
+        std::cerr << "ERROR: " << "The startup restore requires a snapshot file (option --snapshot)." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+
+    if (dispatchName != "static" && dispatchName != "virtual") {
+        std::cerr << "ERROR: " << "The argument " << dispatchName << " is invalid for option --dispatch." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+
+    if (useAllocator != "default" && useAllocator != "pool") {
+        std::cerr << "ERROR: " << "The argument " << useAllocator << " is invalid for option --allocator." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+
+    if (workModelName == "spin") {
+        work_model = SPIN;
+    } else if (workModelName == "read") {
+        work_model = READ;
+    } else if (workModelName == "write") {
+        work_model = WRITE;
+    } else if (workModelName == "sleep") {
+        work_model = SLEEP;
+    } else {
+        std::cerr << "ERROR: " << "The argument " << workModelName << " is invalid for option --work_model." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+    work_bytes = workBytes;
+
+    block_count = blockCount;
+    huge_pages = useHugePages;
+    free_batch_size = freeBatchSize ? freeBatchSize : std::max(uint_fast32_t(1), uint_fast32_t(0.1 * blockCount));
+    if (free_batch_size > block_count) {
+        std::cerr << "ERROR: " << "The argument " << free_batch_size << " is invalid for option --free_batch (more than --blocks)." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+
     thread_count = threadCount;
+    init_thread_count = initThreadCount;
+    // Otherwise, the refill could run out of victims as all the other free pages are stranded in magazines:
+    if (uint_fast64_t(magazineSize) * thread_count + free_batch_size > block_count - 1) {
+        std::cerr << "ERROR: " << "The argument " << magazineSize << " is invalid for option --magazine_size (the magazines of all threads and --free_batch exceed --blocks - 1)." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
     iteration_count = iterationsCount;
-    free_batch_size = freeBatchSize;
     work_time_ns = workTimeInNS;
     timeout_ns = timeoutInNS;
 
     move = useMove;
 
+    shard_count = shardCount;
+    if (stealPolicyName == "random") {
+        steal_policy = RANDOM_VICTIM;
+    } else if (stealPolicyName == "round_robin") {
+        steal_policy = ROUND_ROBIN;
+    } else if (stealPolicyName == "largest") {
+        steal_policy = LARGEST_FIRST;
+    } else {
+        std::cerr << "ERROR: " << "The argument " << stealPolicyName << " is invalid for option --steal." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+
+    virtual_nodes = virtualNodeCount;
+    if (virtual_nodes > block_count - 1) {
+        std::cerr << "ERROR: " << "The argument " << virtual_nodes << " is invalid for option --virtual_nodes (more than --blocks - 1)." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+    if (numaFallbackName == "nearest") {
+        numa_fallback = NEAREST_NODE;
+    } else if (numaFallbackName == "largest") {
+        numa_fallback = LARGEST_NODE;
+    } else if (numaFallbackName == "local_only") {
+        numa_fallback = LOCAL_ONLY;
+    } else {
+        std::cerr << "ERROR: " << "The argument " << numaFallbackName << " is invalid for option --numa_fallback." << std::endl << std::endl;
+        std::cerr << *allOptions << std::endl;
+        exit(1);
+    }
+    // The refills of the NUMA free list only evict frames of their own node, which the magazines mustn't be able to strand:
+    if (useQueue == "numa") {
+        uint_fast32_t nodeCount = NUMATopology(virtual_nodes).nodeCount();
+        uint_fast64_t framesPerNode = (block_count - 1) / nodeCount;
+        if (uint_fast64_t(magazineSize) * thread_count + NUMAFreeList<>::refillTarget(nodeCount) > framesPerNode) {
+            std::cerr << "ERROR: " << "The argument " << magazineSize << " is invalid for option --magazine_size (the magazines of all threads and the refill target of a node exceed the " << framesPerNode << " frames per NUMA node)." << std::endl << std::endl;
+            std::cerr << *allOptions << std::endl;
+            exit(1);
+        }
+    }
+
     extended_output = extendedOutput;
     debug = debugOutput;
 }
 
 void FreeListQueueAlternatives::initialize() {
-    if (extended_output) std::cout << "Start initialization of the free list with " << (block_count - 1) << " free pages." << std::endl;
+    if (extended_output) std::cout << "Start initialization of the free list" << (startupName == "restore" ? " from the snapshot " + snapshotFile : "") << "." << std::endl;
 
     cds::Initialize();
-    cds::gc::HP garbadge_collector(0, thread_count + 1, 0);
+    garbageCollector = std::make_unique<cds::gc::HP>(0, thread_count + 1, 0);
+
+#ifdef ZERO_EVALUATION_TRACING
+    EventTracer::instance().start(traceBufferSize);
+#endif // ZERO_EVALUATION_TRACING
+
+    popLatency.reset();
+    refillLatency.reset();
+    threadStatistics.clear();
+    magazineHits = 0;
+    magazineMisses = 0;
+    strandedFrames = 0;
+#ifdef ZERO_EVALUATION_CONTENTION
+    contention = ContentionCounters();
+#endif // ZERO_EVALUATION_CONTENTION
+
+    // The footprint of the free list is the heap growth of this thread and the fill threads during its construction (even if the allocations aren't counted otherwise,
+    // but the memory of the scalable allocator of TBB is only counted with --allocations):
+    bool countingEnabled = allocationCountingEnabled;
+    allocationCountingEnabled = true;
+    int_fast64_t heapBytesBefore = threadAllocationCounters.heapBytes;
+    fillHeapBytes = 0;
+    if (pageIDSize == sizeof(uint16_t)) {
+        initializeFreeList<uint16_t>();
+    } else if (pageIDSize == sizeof(uint32_t)) {
+        initializeFreeList<uint32_t>();
+    } else {
+        initializeFreeList<uint_fast32_t>();
+    }
+    int_fast64_t heapGrowth = threadAllocationCounters.heapBytes - heapBytesBefore + fillHeapBytes;
+    footprintBytes = uint_fast64_t(std::max(int_fast64_t(0), heapGrowth)) + queue->unallocatedBytes();
+    allocationCountingEnabled = countingEnabled;
+
+    if (extended_output) std::cout << "Finished initialization of the free list with " << initialFreePages << " free pages." << std::endl;
+}
+
+template <typename PageID>
+void FreeListQueueAlternatives::initializeFreeList() {
+    FrameArray<PageID>& typedPageIDs = pageIDsOf<PageID>();
+    typedPageIDs.allocate(block_count, huge_pages);
+    for (uint_fast32_t i = 0; i < block_count; i++) {
+        typedPageIDs[i] = PageID(i);
+    }
 
-    std::iota(pageIDs.begin(), pageIDs.end(), 0);
-    for (uint_fast32_t i = 1; i < block_count; i++) {
-        pageUnused[i].test_and_set(std::memory_order_consume);
+    // The startup consists of the initialization of the frame states and of the free list:
+    uint_fast64_t startupStart = BenchmarkClock::now();
+    pageUnused.allocate(block_count, huge_pages);
+    const PageID* freePageIDs;
+    FreeListSnapshot snapshot;
+    if (startupName == "restore") {
+        try {
+            snapshot.open(snapshotFile);
+        } catch (const std::runtime_error& error) {
+            std::cerr << "ERROR: " << error.what() << std::endl;
+            exit(1);
+        }
+        if (snapshot.header().blockCount != block_count || snapshot.header().pageIDBytes != sizeof(PageID)) {
+            std::cerr << "ERROR: " << "The snapshot file " << snapshotFile << " has " << snapshot.header().blockCount << " blocks with page IDs of "
+                      << snapshot.header().pageIDBytes << " bytes instead of " << block_count << " blocks with page IDs of " << sizeof(PageID) << " bytes." << std::endl;
+            exit(1);
+        }
+        for (uint_fast32_t i = 1; i < block_count; i++) {
+            if (snapshot.frameUnused(i)) pageUnused[i].test_and_set(std::memory_order_consume);
+        }
+        freePageIDs = snapshot.pageIDs<PageID>();
+        initialFreePages = snapshot.header().freePageCount;
+    } else {
+        for (uint_fast32_t i = 1; i < block_count; i++) {
+            pageUnused[i].test_and_set(std::memory_order_consume);
+        }
+        freePageIDs = &typedPageIDs[1];
+        initialFreePages = block_count - 1;
     }
 
+    FreeListOf<PageID>* freeList;
+    bool pool = useAllocator == "pool";
     if (useQueue == "boost::lockfree::queue")
-        queue = new BoostLockFreeQueue();
+        freeList = pool ? static_cast<FreeListOf<PageID>*>(new BoostLockFreeQueue<PageID, PoolAllocator<PageID>>()) : new BoostLockFreeQueue<PageID>();
     else if (useQueue == "boost::lockfree::queue_fixed_size")
-        queue = new BoostLockfreeQueueFixedSize();
+        freeList = new BoostLockfreeQueueFixedSize<PageID>();
     else if (useQueue == "cds::container::BasketQueue")
-        queue = new CDSContainerBasketQueue();
+        freeList = pool ? static_cast<FreeListOf<PageID>*>(new CDSContainerBasketQueue<PageID, PoolAllocator<PageID>>()) : new CDSContainerBasketQueue<PageID>();
     else if (useQueue == "cds::container::FCQueue")
-        queue = new CDSContainerFCQueue();
+        freeList = new CDSContainerFCQueue<PageID>();
     else if (useQueue == "cds::container::MoirQueue")
-        queue = new CDSContainerMoirqueue();
+        freeList = new CDSContainerMoirqueue<PageID>();
     else if (useQueue == "cds::container::MSQueue")
-        queue = new CDSContainerMSQueue();
+        freeList = pool ? static_cast<FreeListOf<PageID>*>(new CDSContainerMSQueue<PageID, PoolAllocator<PageID>>()) : new CDSContainerMSQueue<PageID>();
     else if (useQueue == "cds::container::OptimisticQueue")
-        queue = new CDSContainerOptimisticQueue();
+        freeList = new CDSContainerOptimisticQueue<PageID>();
     else if (useQueue == "cds::container::RWQueue")
-        queue = new CDSContainerRWQueue();
+        freeList = new CDSContainerRWQueue<PageID>();
     else if (useQueue == "cds::container::SegmentedQueue")
-        queue = new CDSContainerSegmentedQueue();
+        freeList = new CDSContainerSegmentedQueue<PageID>();
     else if (useQueue == "cds::container::VyukovMPMCCycleQueue")
-        queue = new CDSContainerVyukovMPMCCycleQueue();
+        freeList = new CDSContainerVyukovMPMCCycleQueue<PageID>();
     else if (useQueue == "folly::MPMCQueue")
-        queue = new FollyMPMCQueue();
+        freeList = new FollyMPMCQueue<PageID>();
     else if (useQueue == "legacy")
-        queue = new LegacyZeroStack();
+        freeList = new LegacyZeroStack<PageID>();
+    else if (useQueue == "legacy_lockfree")
+        freeList = new LockFreeZeroStack<PageID>();
     else if (useQueue == "lockfree_queue::mpmc_fixed_bounded_value")
-        queue = new LockfreeQueueMPMCFixedBoundedValue();
+        freeList = new LockfreeQueueMPMCFixedBoundedValue<PageID>();
     else if (useQueue == "moodycamel::ConcurrentQueue")
-        queue = new MoodycamelConcurrentQueue();
+        freeList = new MoodycamelConcurrentQueue<PageID>();
     else if (useQueue == "mpmc_bounded_queue")
-        queue = new MPMCBoundedQueue();
+        freeList = new MPMCBoundedQueue<PageID>();
     else if (useQueue == "mpmc_bounded_queue_t")
-        queue = new MPMCBoundedQueueT();
+        freeList = new MPMCBoundedQueueT<PageID>();
+    else if (useQueue == "numa")
+        freeList = new NUMAFreeList<PageID>();
     else if (useQueue == "rigtorp::MPMCQueue")
-        queue = new RigtorpMPMCQueue();
+        freeList = new RigtorpMPMCQueue<PageID>();
+    else if (useQueue == "sharded")
+        freeList = new ShardedFreeList<PageID>();
     else if (useQueue == "tbb::concurrent_bounded_queue")
-        queue = new TBBConcurrentBoundedQueue();
+        freeList = countAllocations ? static_cast<FreeListOf<PageID>*>(new TBBConcurrentBoundedQueue<PageID, CountedCacheAlignedAllocator<PageID>>()) : new TBBConcurrentBoundedQueue<PageID>();
     else if (useQueue == "tbb::concurrent_queue")
-        queue = new TBBConcurrentQueue();
+        freeList = pool ? static_cast<FreeListOf<PageID>*>(new TBBConcurrentQueue<PageID, PoolAllocator<PageID>>())
+                        : countAllocations ? static_cast<FreeListOf<PageID>*>(new TBBConcurrentQueue<PageID, CountedCacheAlignedAllocator<PageID>>())
+                        : new TBBConcurrentQueue<PageID>();
     else {
         std::cerr << "ERROR: " << "The argument " << useQueue << " is invalid for option --queue." << std::endl << std::endl;
         std::cerr << allOptions << std::endl;
         exit(1);
     }
 
-    if (extended_output) std::cout << "Finished initialization of the free list with " << (block_count - 1) << " free pages." << std::endl;
+    // Each thread fills the free list with a contiguous range of the page IDs:
+    uint_fast32_t fillThreadCount = uint_fast32_t(std::max(uint_fast64_t(1), std::min(uint_fast64_t(initThreadCount), initialFreePages)));
+    auto fill = [&](uint_fast32_t fillThread) {
+        int_fast64_t heapBytesBefore = threadAllocationCounters.heapBytes;
+        {
+            std::unique_ptr<FreeListContext> context = freeList->createContext();
+            freeList->fill(*context, freePageIDs, initialFreePages,
+                           initialFreePages * fillThread / fillThreadCount,
+                           initialFreePages * (fillThread + 1) / fillThreadCount);
+        }
+        fillHeapBytes += threadAllocationCounters.heapBytes - heapBytesBefore;
+    };
+    // Only the allocations of the fills count towards the footprint and not the ones of the threads running them:
+    int_fast64_t heapBytesBeforeFill = threadAllocationCounters.heapBytes;
+    if (fillThreadCount == 1) {
+        fill(0);
+    } else {
+        std::vector<std::thread> fillThreads;
+        for (uint_fast32_t i = 0; i < fillThreadCount; i++) {
+            fillThreads.emplace_back(fill, i);
+        }
+        for (std::thread& fillThread : fillThreads) {
+            fillThread.join();
+        }
+    }
+    fillHeapBytes -= threadAllocationCounters.heapBytes - heapBytesBeforeFill;
+    freeList->init(freePageIDs, initialFreePages);
+    startupTimeInNS = BenchmarkClock::toNanoseconds(BenchmarkClock::now() - startupStart);
+    queue = freeList;
+
+    // The snapshot is taken of the full free list, so a restore loads the same pages as the cold startup (and restores don't overwrite it):
+    if (startupName == "cold" && !snapshotFile.empty()) {
+        try {
+            FreeListSnapshot::write<PageID>(snapshotFile, block_count, freePageIDs, initialFreePages);
+        } catch (const std::runtime_error& error) {
+            std::cerr << "ERROR: " << error.what() << std::endl;
+            exit(1);
+        }
+    }
 }
 
 void FreeListQueueAlternatives::printSpecificConfiguration() {
-    std::cout << "\t" << block_count << "\t" << freeBatchSize << "\t" << useQueue << "\t" << (useMove ? "move" : "") << "\t" << workTimeInNS;
+    std::cout << "\t" << block_count << "\t" << free_batch_size << "\t" << useQueue << "\t" << (useMove ? "move" : "") << "\t" << workTimeInNS;
+    if (useAllocator != "default" || !sweepAllocators.empty()) std::cout << "\t" << useAllocator;
+    if (dispatchName != "static") std::cout << "\t" << dispatchName;
+    if (pageIDName != "uint_fast32" || !sweepPageIDs.empty()) std::cout << "\t" << pageIDName;
+    if (initThreadCount != 1 || !sweepInitThreadCounts.empty()) std::cout << "\t" << initThreadCount;
+    if (startupName != "cold" || !sweepStartups.empty()) std::cout << "\t" << startupName;
+    if (bulkSize != 1 || !sweepBulkSizes.empty()) std::cout << "\t" << bulkSize;
+    if (magazineSize != 0 || !sweepMagazineSizes.empty()) std::cout << "\t" << magazineSize;
+    if (useQueue == "sharded" || sweepQueues.find("sharded") != std::string::npos || !sweepShardCounts.empty() || !sweepStealPolicies.empty()) std::cout << "\t" << (shard_count ? shard_count : thread_count) << "\t" << stealPolicyName;
+    if (useQueue == "numa" || sweepQueues.find("numa") != std::string::npos || !sweepVirtualNodeCounts.empty() || !sweepNUMAFallbacks.empty()) std::cout << "\t" << virtual_nodes << "\t" << numaFallbackName;
 }
 
 void FreeListQueueAlternatives::printSpecificConfigurationExtended() {
     std::cout << "Blocks: " << block_count << std::endl;
-    std::cout << "Free Batch Size: " << freeBatchSize << std::endl;
+    std::cout << "Huge Pages: " << (huge_pages ? (pageUnused.explicitHugePages() ? "Yes (explicit)" : "Yes (transparent)") : "No") << std::endl;
+    std::cout << "Free Batch Size: " << free_batch_size << std::endl;
     std::cout << "Concurrent Queue: " << useQueue << std::endl;
+    std::cout << "Page IDs: " << pageIDName << " (" << pageIDSize << " Bytes)" << std::endl;
+    std::cout << "Free List Footprint: " << footprintBytes << " Bytes (" << double(footprintBytes) / double(block_count - 1) << " Bytes per Entry)" << std::endl;
+    std::cout << "Initialization Threads: " << initThreadCount << std::endl;
+    std::cout << "Startup: " << (startupName == "restore" ? "restore from " + snapshotFile : startupName) << " (" << initialFreePages << " free pages)" << std::endl;
+    std::cout << "Startup Time: " << startupTimeInNS << "ns" << std::endl;
+    std::cout << "Bulk Size: " << bulkSize << std::endl;
+    std::cout << "Magazine Size: " << magazineSize << std::endl;
+    if (useQueue == "sharded") std::cout << "Shards: " << (shard_count ? shard_count : thread_count) << " (stealing from the " << stealPolicyName << " shard)" << std::endl;
+    if (useQueue == "numa") std::cout << "NUMA Nodes: " << NUMATopology(virtual_nodes).nodeCount() << (virtual_nodes ? " (virtual)" : "") << " (fallback: " << numaFallbackName << ")" << std::endl;
+    std::cout << "Allocator: " << useAllocator << std::endl;
+    std::cout << "Dispatch: " << dispatchName << std::endl;
     std::cout << "Use std::move: " << (useMove ? "Yes" : "No") << std::endl;
     std::cout << "Work Time: " << std::chrono::nanoseconds(workTimeInNS) << std::endl;
+    std::cout << "Work Model: " << workModelName;
+    if (work_model == READ || work_model == WRITE) std::cout << " (" << workBytes << " Bytes)";
+    std::cout << std::endl;
+    std::cout << "Record Latency: " << (recordLatency ? "Yes" : "No") << std::endl;
+    std::cout << "Record Thread Statistics: " << (recordThreadStatistics ? "Yes" : "No") << std::endl;
+#ifdef ZERO_EVALUATION_TRACING
+    std::cout << "Trace File: " << traceFile << std::endl;
+#endif // ZERO_EVALUATION_TRACING
+}
+
+void FreeListQueueAlternatives::runWorker(uint_fast32_t threadIndex, ThreadProgress& progress) {
+    auto loop = [&](auto& freeList) {
+        doWork(threadIndex, progress, [&]{operate(freeList);});
+    };
+    if (dispatchName == "static" && (FreeListsOf<uint16_t>::dispatch(queue, loop)
+                                     || FreeListsOf<uint32_t>::dispatch(queue, loop)
+                                     || FreeListsOf<uint_fast32_t>::dispatch(queue, loop))) return;
+
+    Evaluation::runWorker(threadIndex, progress);
 }
 
 void FreeListQueueAlternatives::work() {
-    queue->use(pageIDs, pageUnused);
+    if (pageIDSize == sizeof(uint16_t)) {
+        operate(*static_cast<FreeListOf<uint16_t>*>(queue));
+    } else if (pageIDSize == sizeof(uint32_t)) {
+        operate(*static_cast<FreeListOf<uint32_t>*>(queue));
+    } else {
+        operate(*static_cast<FreeListOf<uint_fast32_t>*>(queue));
+    }
+}
+
+template <typename Queue>
+inline void FreeListQueueAlternatives::operate(Queue& freeList) {
+    if (recordLatency || recordThreadStatistics) {
+        uint_fast64_t start = BenchmarkClock::now();
+        bool popSuccessful = useFreeList(freeList);
+        uint_fast64_t latency = BenchmarkClock::toNanoseconds(BenchmarkClock::now() - start);
+        if (popSuccessful) {
+            if (recordLatency) threadPopLatency.record(latency);
+            threadStatistic.pops++;
+        } else {
+            if (recordLatency) threadRefillLatency.record(latency);
+            threadStatistic.refills++;
+        }
+        if (latency > threadStatistic.longestUseInNS) threadStatistic.longestUseInNS = latency;
+    } else {
+        useFreeList(freeList);
+    }
+}
+
+template <typename Queue>
+inline bool FreeListQueueAlternatives::useFreeList(Queue& freeList) {
+    using PageID = typename Queue::page_id_type;
+    if (magazineSize > 0) {
+        return useMagazine(freeList, *threadContext, pageUnused, threadMagazine<PageID>);
+    } else if (bulkSize > 1) {
+        return useBulk(freeList, *threadContext, pageUnused, threadBatch<PageID>.data(), bulkSize);
+    } else {
+        return freeList.use(*threadContext, pageIDsOf<PageID>(), pageUnused);
+    }
+}
+
+bool FreeListQueueAlternatives::sampleSpecific(int_fast64_t& value) {
+    return queue->approximateLength(value);
+}
+
+std::string FreeListQueueAlternatives::sampleSpecificName() {
+    return "Free List Length";
 }
 
-void FreeListQueueAlternatives::before() {
-    if (queue->useCDSThreadManagement()) cds::threading::Manager::attachThread();
+void FreeListQueueAlternatives::before(uint_fast32_t threadIndex) {
+    threadContext = queue->createWorkerContext(threadIndex);
+    if (pageIDSize == sizeof(uint16_t)) {
+        threadBatch<uint16_t>.resize(bulkSize);
+        threadMagazine<uint16_t>.resize(magazineSize);
+    } else if (pageIDSize == sizeof(uint32_t)) {
+        threadBatch<uint32_t>.resize(bulkSize);
+        threadMagazine<uint32_t>.resize(magazineSize);
+    } else {
+        threadBatch<uint_fast32_t>.resize(bulkSize);
+        threadMagazine<uint_fast32_t>.resize(magazineSize);
+    }
+}
+
+void FreeListQueueAlternatives::afterWarmUp() {
+    if (recordLatency) {
+        threadPopLatency.reset();
+        threadRefillLatency.reset();
+    }
+    threadStatistic = ThreadStatistics();
+    // The pages in the magazines are kept, only their statistics are reset:
+    threadMagazine<uint16_t>.hits = threadMagazine<uint16_t>.misses = 0;
+    threadMagazine<uint32_t>.hits = threadMagazine<uint32_t>.misses = 0;
+    threadMagazine<uint_fast32_t>.hits = threadMagazine<uint_fast32_t>.misses = 0;
+#ifdef ZERO_EVALUATION_CONTENTION
+    threadContentionCounters = ContentionCounters();
+#endif // ZERO_EVALUATION_CONTENTION
 }
 
 void FreeListQueueAlternatives::after() {
-    if (queue->useCDSThreadManagement()) cds::threading::Manager::detachThread();
+    if (recordLatency || recordThreadStatistics) {
+        std::lock_guard<std::mutex> lock(threadResultMutex);
+        if (recordLatency) {
+            popLatency.merge(threadPopLatency);
+            refillLatency.merge(threadRefillLatency);
+        }
+        threadStatistics.push_back(threadStatistic);
+    }
+#ifdef ZERO_EVALUATION_CONTENTION
+    {
+        std::lock_guard<std::mutex> lock(threadResultMutex);
+        contention.merge(threadContentionCounters);
+    }
+#endif // ZERO_EVALUATION_CONTENTION
+    if (magazineSize > 0) {
+        if (pageIDSize == sizeof(uint16_t)) {
+            releaseMagazine<uint16_t>();
+        } else if (pageIDSize == sizeof(uint32_t)) {
+            releaseMagazine<uint32_t>();
+        } else {
+            releaseMagazine<uint_fast32_t>();
+        }
+    }
+    threadContext.reset();
+}
+
+template <typename PageID>
+void FreeListQueueAlternatives::releaseMagazine() {
+    Magazine<PageID>& magazine = threadMagazine<PageID>;
+    {
+        std::lock_guard<std::mutex> lock(threadResultMutex);
+        magazineHits += magazine.hits;
+        magazineMisses += magazine.misses;
+        strandedFrames += magazine.count;
+    }
+    flushMagazine(*static_cast<FreeListOf<PageID>*>(queue), *threadContext, magazine);
+}
+
+void FreeListQueueAlternatives::specificConfigurationRecord(ResultRecord& record) {
+    record.set("queue", useQueue);
+    record.set("blocks", std::to_string(block_count));
+    record.set("huge_pages", huge_pages ? "true" : "false");
+    record.set("free_batch", std::to_string(free_batch_size));
+    record.set("page_id", pageIDName);
+    record.set("init_threads", std::to_string(initThreadCount));
+    record.set("startup", startupName);
+    record.set("bulk_size", std::to_string(bulkSize));
+    record.set("magazine_size", std::to_string(magazineSize));
+    record.set("shards", std::to_string(shard_count ? shard_count : thread_count));
+    record.set("steal", stealPolicyName);
+    record.set("numa_nodes", std::to_string(NUMATopology(virtual_nodes).nodeCount()));
+    record.set("virtual_nodes", std::to_string(virtual_nodes));
+    record.set("numa_fallback", numaFallbackName);
+    record.set("allocator", useAllocator);
+    record.set("dispatch", dispatchName);
+    record.set("move", useMove ? "true" : "false");
+    record.set("work", std::to_string(workTimeInNS));
+    record.set("work_model", workModelName);
+    record.set("work_bytes", std::to_string(work_model == READ || work_model == WRITE ? workBytes : 0));
+}
+
+void FreeListQueueAlternatives::specificResultRecord(ResultRecord& record) {
+    record.set("page_id_bytes", double(pageIDSize));
+    record.set("footprint_bytes", double(footprintBytes));
+    record.set("footprint_bytes_per_entry", double(footprintBytes) / double(block_count - 1));
+    record.set("startup_ns", double(startupTimeInNS));
+    // Each record has the same fields (as the header of a CSV file comes from the first one), which are 0 without magazines:
+    record.set("magazine_hit_rate", magazineHitRate());
+    record.set("stranded_frames", double(strandedFrames));
+    if (recordLatency) {
+        for (auto path : {std::make_pair("pop", &popLatency), std::make_pair("refill", &refillLatency)}) {
+            std::string prefix = std::string(path.first) + "_latency_";
+            record.set(prefix + "count", double(path.second->count()));
+            record.set(prefix + "p50_ns", double(path.second->percentile(50.0)));
+            record.set(prefix + "p99_ns", double(path.second->percentile(99.0)));
+            record.set(prefix + "p99_9_ns", double(path.second->percentile(99.9)));
+            record.set(prefix + "max_ns", double(path.second->max()));
+        }
+    }
+    if (recordThreadStatistics) {
+        for (auto statistic : {std::make_pair("pops", &ThreadStatistics::pops), std::make_pair("refills", &ThreadStatistics::refills), std::make_pair("longest_call_ns", &ThreadStatistics::longestUseInNS)}) {
+            std::vector<double> values = threadStatisticValues(statistic.second);
+            Summary summary = summarize(values);
+            record.set(std::string(statistic.first) + "_per_thread_min", summary.min);
+            record.set(std::string(statistic.first) + "_per_thread_max", summary.max);
+            record.set(std::string(statistic.first) + "_per_thread_mean", summary.mean);
+            record.set(std::string(statistic.first) + "_per_thread_stddev", summary.stddev);
+            record.set(std::string(statistic.first) + "_jain_fairness_index", jainFairnessIndex(values));
+        }
+    }
+#ifdef ZERO_EVALUATION_CONTENTION
+    for (uint_fast32_t i = 0; i < CONTENTION_COUNTER_COUNT; i++) {
+        bool time = i == LOCK_WAIT_TICKS || i == LOCK_HOLD_TICKS;
+        double value = time ? double(BenchmarkClock::toNanoseconds(contention.values[i])) : double(contention.values[i]);
+        record.set(recordKey(contentionCounterNames[i]) + (time ? "_ns" : ""), value);
+    }
+#endif // ZERO_EVALUATION_CONTENTION
+}
+
+void FreeListQueueAlternatives::printSpecificResult() {
+    if (magazineSize != 0 || !sweepMagazineSizes.empty()) std::cout << "\t" << magazineHitRate() << "\t" << strandedFrames;
+    if (recordLatency) {
+        for (const LatencyHistogram* latency : {&popLatency, &refillLatency}) {
+            std::cout << "\t" << latency->count()
+                      << "\t" << latency->percentile(50.0)
+                      << "\t" << latency->percentile(99.0)
+                      << "\t" << latency->percentile(99.9)
+                      << "\t" << latency->max();
+        }
+    }
+    if (recordThreadStatistics) {
+        for (uint_fast64_t ThreadStatistics::* statistic : {&ThreadStatistics::pops, &ThreadStatistics::refills, &ThreadStatistics::longestUseInNS}) {
+            Summary summary = summarizeThreadStatistic(statistic);
+            std::cout << "\t" << uint_fast64_t(summary.min) << "\t" << uint_fast64_t(summary.max);
+        }
+    }
+}
+
+void FreeListQueueAlternatives::printSpecificResultExtended() {
+    if (magazineSize > 0) {
+        std::cout << "Magazine Hit Rate: " << 100.0 * magazineHitRate() << "% (" << magazineHits << " of " << magazineHits + magazineMisses << " Calls)" << std::endl;
+        std::cout << "Stranded Frames: " << strandedFrames << " (" << 100.0 * double(strandedFrames) / double(block_count - 1) << "% of the Blocks)" << std::endl;
+    }
+    if (recordLatency) {
+        printLatency("Pop", popLatency);
+        printLatency("Refill", refillLatency);
+    }
+    if (recordThreadStatistics) {
+        printThreadStatistic("Successful Pops per Thread", &ThreadStatistics::pops);
+        printThreadStatistic("Refills per Thread", &ThreadStatistics::refills);
+        printThreadStatistic("Longest Call per Thread (ns)", &ThreadStatistics::longestUseInNS);
+    }
+#ifdef ZERO_EVALUATION_CONTENTION
+    printContention();
+#endif // ZERO_EVALUATION_CONTENTION
+}
+
+#ifdef ZERO_EVALUATION_CONTENTION
+void FreeListQueueAlternatives::printContention() {
+    double operations = double(threadCount) * double(iterationsCount);
+    double acquisitions = double(contention.values[LOCK_ACQUISITIONS]);
+    for (uint_fast32_t i = 0; i < CONTENTION_COUNTER_COUNT; i++) {
+        std::cout << contentionCounterNames[i] << ": ";
+        if (i == LOCK_WAIT_TICKS || i == LOCK_HOLD_TICKS) {
+            uint_fast64_t timeInNS = BenchmarkClock::toNanoseconds(contention.values[i]);
+            std::cout << std::chrono::nanoseconds(timeInNS)
+                      << " (" << (acquisitions > 0 ? double(timeInNS) / acquisitions : 0.0) << "ns per Acquisition)" << std::endl;
+        } else {
+            std::cout << contention.values[i] << " (" << double(contention.values[i]) / operations << " per Operation)" << std::endl;
+        }
+    }
+}
+#endif // ZERO_EVALUATION_CONTENTION
+
+void FreeListQueueAlternatives::printLatency(const std::string& path, const LatencyHistogram& latency) {
+    std::cout << path << " Latency: " << latency.count() << " calls"
+              << ", min " << latency.min() << "ns"
+              << ", mean " << std::fixed << std::setprecision(1) << latency.mean() << "ns"
+              << ", p50 " << latency.percentile(50.0) << "ns"
+              << ", p90 " << latency.percentile(90.0) << "ns"
+              << ", p99 " << latency.percentile(99.0) << "ns"
+              << ", p99.9 " << latency.percentile(99.9) << "ns"
+              << ", p99.99 " << latency.percentile(99.99) << "ns"
+              << ", max " << latency.max() << "ns" << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+double FreeListQueueAlternatives::magazineHitRate() const {
+    return magazineHits + magazineMisses > 0 ? double(magazineHits) / double(magazineHits + magazineMisses) : 0.0;
 }
 
-void FreeListQueueAlternatives::printSpecificResult() {}
+std::vector<double> FreeListQueueAlternatives::threadStatisticValues(uint_fast64_t ThreadStatistics::* statistic) {
+    std::vector<double> values;
+    for (const ThreadStatistics& thread : threadStatistics) values.push_back(double(thread.*statistic));
+    return values;
+}
 
-void FreeListQueueAlternatives::printSpecificResultExtended() {}
+Summary FreeListQueueAlternatives::summarizeThreadStatistic(uint_fast64_t ThreadStatistics::* statistic) {
+    return summarize(threadStatisticValues(statistic));
+}
+
+void FreeListQueueAlternatives::printThreadStatistic(const std::string& name, uint_fast64_t ThreadStatistics::* statistic) {
+    Summary summary = summarizeThreadStatistic(statistic);
+    std::cout << name << ": min " << uint_fast64_t(summary.min)
+              << ", max " << uint_fast64_t(summary.max)
+              << ", mean " << std::fixed << std::setprecision(1) << summary.mean
+              << ", stddev " << summary.stddev << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6);
+}
 
 void FreeListQueueAlternatives::unInitialize() {
+#ifdef ZERO_EVALUATION_TRACING
+    if (!EventTracer::instance().dump(traceFile)) {
+        std::cerr << "ERROR: " << "The trace file " << traceFile << " could not be written." << std::endl;
+    }
+#endif // ZERO_EVALUATION_TRACING
+
+    // The free list gets rebuilt for each trial and each configuration of a sweep:
+    delete(queue);
+    queue = nullptr;
+    std::get<0>(pageIDs).release();
+    std::get<1>(pageIDs).release();
+    std::get<2>(pageIDs).release();
+    pageUnused.release();
+    garbageCollector.reset();
     cds::Terminate();
 }
 
@@ -2,8 +2,29 @@
 #define __free_list_queue_alternatives_H_
 
 #include "../evaluation_framework.hpp"
+#include "../latency_histogram.hpp"
+#include "../event_tracer.hpp"
+#include "../contention_counters.hpp"
+
+#include <cds/gc/hp.h>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+struct ThreadStatistics {
+    uint_fast64_t   pops = 0;
+    uint_fast64_t   refills = 0;
+    uint_fast64_t   longestUseInNS = 0;
+};
 
 #include "free_list.hpp"
+#include "free_list_bulk.hpp"
+#include "free_list_magazine.hpp"
+#include "free_list_snapshot.hpp"
 #include "boost_lockfree_queue.hpp"
 #include "boost_lockfree_queue_fixed_size.hpp"
 #include "cds_container_basketqueue.hpp"
@@ -16,28 +37,98 @@
 #include "cds_container_vyukovmpmccyclequeue.hpp"
 #include "folly_mpmcqueue.hpp"
 #include "legacy_zero_stack.hpp"
+#include "lockfree_zero_stack.hpp"
 #include "lockfree_queue_mpmc_fixed_bounded_value.hpp"
 #include "moodycamel_concurrent_queue.hpp"
 #include "mpmc_bounded_queue.hpp"
 #include "mpmc_bounded_queue_t.hpp"
+#include "numa_free_list.hpp"
 #include "rigtorp_mpmcqueue.hpp"
+#include "sharded_free_list.hpp"
 #include "tbb_concurrent_bounded_queue.hpp"
 #include "tbb_concurrent_queue.hpp"
 
+/**\brief The concrete free list types a worker loop gets instantiated for.
+ *
+ * As the adapters are \c final, calling \c use() on their concrete type
+ * doesn't need a virtual call and can be inlined.
+ */
+template <typename... FreeLists>
+struct FreeListTypes {
+    /// Calls the function with the free list cast to its concrete type (returns \c false if it's none of the types).
+    template <typename Function>
+    static bool dispatch(FreeList* freeList, Function function) {
+        return (dispatchAs<FreeLists>(freeList, function) || ...);
+    }
+
+private:
+    template <typename Concrete, typename Function>
+    static bool dispatchAs(FreeList* freeList, Function& function) {
+        Concrete* concrete = dynamic_cast<Concrete*>(freeList);
+        if (concrete) function(*concrete);
+        return concrete;
+    }
+};
+
+/// The free lists storing page IDs of the given type.
+template <typename PageID>
+using FreeListsOf = FreeListTypes<BoostLockFreeQueue<PageID>,
+                                  BoostLockFreeQueue<PageID, PoolAllocator<PageID>>,
+                                  BoostLockfreeQueueFixedSize<PageID>,
+                                  CDSContainerBasketQueue<PageID>,
+                                  CDSContainerBasketQueue<PageID, PoolAllocator<PageID>>,
+                                  CDSContainerFCQueue<PageID>,
+                                  CDSContainerMoirqueue<PageID>,
+                                  CDSContainerMSQueue<PageID>,
+                                  CDSContainerMSQueue<PageID, PoolAllocator<PageID>>,
+                                  CDSContainerOptimisticQueue<PageID>,
+                                  CDSContainerRWQueue<PageID>,
+                                  CDSContainerSegmentedQueue<PageID>,
+                                  CDSContainerVyukovMPMCCycleQueue<PageID>,
+                                  FollyMPMCQueue<PageID>,
+                                  LegacyZeroStack<PageID>,
+                                  LockFreeZeroStack<PageID>,
+                                  LockfreeQueueMPMCFixedBoundedValue<PageID>,
+                                  MoodycamelConcurrentQueue<PageID>,
+                                  MPMCBoundedQueue<PageID>,
+                                  MPMCBoundedQueueT<PageID>,
+                                  NUMAFreeList<PageID>,
+                                  RigtorpMPMCQueue<PageID>,
+                                  ShardedFreeList<PageID>,
+                                  TBBConcurrentBoundedQueue<PageID>,
+                                  TBBConcurrentBoundedQueue<PageID, CountedCacheAlignedAllocator<PageID>>,
+                                  TBBConcurrentQueue<PageID>,
+                                  TBBConcurrentQueue<PageID, CountedCacheAlignedAllocator<PageID>>,
+                                  TBBConcurrentQueue<PageID, PoolAllocator<PageID>>>;
+
 class FreeListQueueAlternatives : public  Evaluation {
 public:
-    FreeListQueueAlternatives() : Evaluation("Benchmark Free List Queue Alternatives") {};
+    FreeListQueueAlternatives() : Evaluation("Benchmark Free List Queue Alternatives"), queue(nullptr) {};
 
     ~FreeListQueueAlternatives() {
         delete(queue);
     }
 
-    std::array<uint_fast32_t, block_count>      pageIDs;
-    std::array<std::atomic_flag, block_count>   pageUnused;
+    std::tuple<FrameArray<uint16_t>, FrameArray<uint32_t>, FrameArray<uint_fast32_t>>   pageIDs;
+    FrameArray<std::atomic_flag>                                                        pageUnused;
+
+    /// The page IDs of the given type (only the ones of the configured type are allocated).
+    template <typename PageID>
+    FrameArray<PageID>& pageIDsOf() {
+        if constexpr (std::is_same<PageID, uint16_t>::value) {
+            return std::get<0>(pageIDs);
+        } else if constexpr (std::is_same<PageID, uint32_t>::value) {
+            return std::get<1>(pageIDs);
+        } else {
+            return std::get<2>(pageIDs);
+        }
+    }
 
 protected:
     void setSpecificOptions();
 
+    std::vector<SweepDimension> specificSweepDimensions();
+
     void setSpecificConfig();
 
     void initialize();
@@ -46,12 +137,24 @@ protected:
 
     void printSpecificConfigurationExtended();
 
+    void runWorker(uint_fast32_t threadIndex, ThreadProgress& progress);
+
     void work();
 
-    void before();
+    bool sampleSpecific(int_fast64_t& value);
+
+    std::string sampleSpecificName();
+
+    void before(uint_fast32_t threadIndex);
+
+    void afterWarmUp();
 
     void after();
 
+    void specificConfigurationRecord(ResultRecord& record);
+
+    void specificResultRecord(ResultRecord& record);
+
     void printSpecificResult();
 
     void printSpecificResultExtended();
@@ -59,13 +162,92 @@ protected:
     void unInitialize();
 
 private:
-    FreeList*       queue;
+    FreeList*                       queue;
+    std::unique_ptr<cds::gc::HP>    garbageCollector;
 
+    uint_fast32_t   blockCount;
+    bool            useHugePages;
     uint_fast32_t   freeBatchSize;
     uint_fast64_t   workTimeInNS;
+    std::string     workModelName;
+    uint_fast32_t   workBytes;
 
     std::string     useQueue;
+    std::string     pageIDName;
+    uint_fast32_t   pageIDSize;
+    uint_fast64_t   footprintBytes;
+    std::atomic<int_fast64_t>   fillHeapBytes;          // the heap growth of the fills less the one of the initializing thread while they ran
+    uint_fast32_t   initThreadCount;
+    std::string     startupName;
+    std::string     snapshotFile;
+    uint_fast64_t   initialFreePages;
+    uint_fast64_t   startupTimeInNS;
+    uint_fast32_t   bulkSize;
+    uint_fast32_t   magazineSize;
+    uint_fast32_t   shardCount;
+    std::string     stealPolicyName;
+    uint_fast32_t   virtualNodeCount;
+    std::string     numaFallbackName;
+    std::string     useAllocator;
     bool            useMove;
+    std::string     dispatchName;
+    bool            recordLatency;
+    bool            recordThreadStatistics;
+#ifdef ZERO_EVALUATION_TRACING
+    std::string     traceFile;
+    uint_fast64_t   traceBufferSize;
+#endif // ZERO_EVALUATION_TRACING
+    std::string     sweepQueues;
+    std::string     sweepPageIDs;
+    std::string     sweepInitThreadCounts;
+    std::string     sweepStartups;
+    std::string     sweepBulkSizes;
+    std::string     sweepMagazineSizes;
+    std::string     sweepShardCounts;
+    std::string     sweepStealPolicies;
+    std::string     sweepVirtualNodeCounts;
+    std::string     sweepNUMAFallbacks;
+    std::string     sweepBlockCounts;
+    std::string     sweepAllocators;
+    std::string     sweepFreeBatchSizes;
+    std::string     sweepWorkTimes;
+
+    std::mutex                      threadResultMutex;
+    LatencyHistogram                popLatency;
+    LatencyHistogram                refillLatency;
+    std::vector<ThreadStatistics>   threadStatistics;
+    uint_fast64_t                   magazineHits;
+    uint_fast64_t                   magazineMisses;
+    uint_fast64_t                   strandedFrames;         // free pages in the magazines at the end of the run
+#ifdef ZERO_EVALUATION_CONTENTION
+    ContentionCounters              contention;
+
+    void printContention();
+#endif // ZERO_EVALUATION_CONTENTION
+
+    template <typename PageID>
+    void initializeFreeList();
+
+    template <typename Queue>
+    inline void operate(Queue& freeList);
+
+    /// One call of the free list with the configured operation (single pages, bulks or magazines).
+    template <typename Queue>
+    inline bool useFreeList(Queue& freeList);
+
+    /// Merges the statistics of the magazine of the calling thread and returns its pages to the free list.
+    template <typename PageID>
+    void releaseMagazine();
+
+    void printLatency(const std::string& path, const LatencyHistogram& latency);
+
+    double magazineHitRate() const;
+
+    std::vector<double> threadStatisticValues(uint_fast64_t ThreadStatistics::* statistic);
+
+    Summary summarizeThreadStatistic(uint_fast64_t ThreadStatistics::* statistic);
+
+    void printThreadStatistic(const std::string& name, uint_fast64_t ThreadStatistics::* statistic);
 
 };
 
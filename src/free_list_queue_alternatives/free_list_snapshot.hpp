@@ -0,0 +1,189 @@
+#ifndef ZERO_DETAILS_EVALUATION_FREE_LIST_SNAPSHOT_HPP
+#define ZERO_DETAILS_EVALUATION_FREE_LIST_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**\brief A memory-mapped snapshot of a free list and of the frame states.
+ *
+ * The snapshot is a header followed by the page IDs in the free list (with the
+ * width of the page ID type of the free list) and by a bitmap with one bit per
+ * frame, set if the frame is unused. Both sections are aligned to 64 bytes.
+ * The free list is restored by bulk loading the page IDs directly from the
+ * mapping.
+ *
+ * A snapshot is taken right after the free list was filled on a cold startup,
+ * so each restore loads the same page IDs as a cold startup does. The page IDs
+ * are those of the unused frames, which are marked in the bitmap. As a restore
+ * passes the page IDs to the free list without further checks, a snapshot is
+ * only opened if they are consistent with the bitmap.
+ */
+class FreeListSnapshot {
+public:
+    static constexpr char       magic[8] = {'Z', 'F', 'L', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint32_t   version = 1;
+
+    struct Header {
+        char        magic[8];
+        uint32_t    version;
+        uint32_t    pageIDBytes;
+        uint64_t    blockCount;
+        uint64_t    freePageCount;
+        uint64_t    pageIDsOffset;
+        uint64_t    bitmapOffset;
+        uint64_t    bytes;
+    };
+
+    FreeListSnapshot() : _mapping(nullptr), _bytes(0) {};
+
+    FreeListSnapshot(const FreeListSnapshot&) = delete;
+    FreeListSnapshot& operator=(const FreeListSnapshot&) = delete;
+
+    ~FreeListSnapshot() {
+        close();
+    };
+
+    /// Writes the snapshot of the free list with the given page IDs (the frames of all others are in use) to the file.
+    template <typename PageID>
+    static void write(const std::string& path, uint_fast64_t blockCount, const PageID* freePageIDs, uint_fast64_t freePageCount) {
+        Header header = {};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.pageIDBytes = sizeof(PageID);
+        header.blockCount = blockCount;
+        header.freePageCount = freePageCount;
+        header.pageIDsOffset = alignedOffset(sizeof(Header));
+        header.bitmapOffset = alignedOffset(header.pageIDsOffset + freePageCount * sizeof(PageID));
+        header.bytes = header.bitmapOffset + (blockCount + 7) / 8;
+
+        int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (file < 0) throw std::runtime_error("The snapshot file " + path + " could not be created.");
+        if (ftruncate(file, header.bytes) != 0) {
+            ::close(file);
+            throw std::runtime_error("The snapshot file " + path + " could not be resized.");
+        }
+        void* mapping = mmap(nullptr, header.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        ::close(file);
+        if (mapping == MAP_FAILED) throw std::runtime_error("The snapshot file " + path + " could not be mapped.");
+
+        char* bytes = static_cast<char*>(mapping);
+        std::memcpy(bytes, &header, sizeof(Header));
+        PageID* pageIDs = reinterpret_cast<PageID*>(bytes + header.pageIDsOffset);
+        uint8_t* bitmap = reinterpret_cast<uint8_t*>(bytes + header.bitmapOffset);
+        for (uint_fast64_t entry = 0; entry < freePageCount; entry++) {
+            pageIDs[entry] = freePageIDs[entry];
+            bitmap[freePageIDs[entry] / 8] |= uint8_t(1 << (freePageIDs[entry] % 8));
+        }
+        msync(mapping, header.bytes, MS_SYNC);
+        munmap(mapping, header.bytes);
+    };
+
+    /// Maps the snapshot file and checks its header and its page IDs.
+    void open(const std::string& path) {
+        close();
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) throw std::runtime_error("The snapshot file " + path + " could not be opened.");
+        struct stat status;
+        if (fstat(file, &status) != 0 || uint_fast64_t(status.st_size) < sizeof(Header)) {
+            ::close(file);
+            throw std::runtime_error("The snapshot file " + path + " is too short.");
+        }
+        _bytes = status.st_size;
+        void* mapping = mmap(nullptr, _bytes, PROT_READ, MAP_PRIVATE | MAP_POPULATE, file, 0);
+        ::close(file);
+        if (mapping == MAP_FAILED) throw std::runtime_error("The snapshot file " + path + " could not be mapped.");
+        _mapping = static_cast<const char*>(mapping);
+
+        const Header& snapshot = header();
+        if (std::memcmp(snapshot.magic, magic, sizeof(magic)) != 0) {
+            close();
+            throw std::runtime_error("The file " + path + " is no free list snapshot.");
+        }
+        if (snapshot.version != version) {
+            uint32_t snapshotVersion = snapshot.version;
+            close();
+            throw std::runtime_error("The snapshot file " + path + " has the unsupported version " + std::to_string(snapshotVersion) + ".");
+        }
+        // The first checks keep the offsets of the other ones from overflowing:
+        if (snapshot.bytes != _bytes || snapshot.blockCount > _bytes * 8 || snapshot.freePageCount >= snapshot.blockCount || snapshot.pageIDBytes > sizeof(uint64_t)
+            || snapshot.pageIDsOffset > _bytes || snapshot.bitmapOffset > _bytes
+            || snapshot.pageIDsOffset + snapshot.freePageCount * snapshot.pageIDBytes > snapshot.bitmapOffset
+            || snapshot.bitmapOffset + (snapshot.blockCount + 7) / 8 > _bytes) {
+            close();
+            throw std::runtime_error("The snapshot file " + path + " is truncated.");
+        }
+        if (!consistent()) {
+            close();
+            throw std::runtime_error("The snapshot file " + path + " is corrupt (its page IDs don't match the unused frames).");
+        }
+    };
+
+    void close() {
+        if (_mapping) munmap(const_cast<char*>(_mapping), _bytes);
+        _mapping = nullptr;
+        _bytes = 0;
+    };
+
+    const Header& header() const {
+        return *reinterpret_cast<const Header*>(_mapping);
+    };
+
+    /// The page IDs in the free list (the type has to match \c Header::pageIDBytes).
+    template <typename PageID>
+    const PageID* pageIDs() const {
+        return reinterpret_cast<const PageID*>(_mapping + header().pageIDsOffset);
+    };
+
+    inline bool frameUnused(uint_fast64_t frame) const {
+        return reinterpret_cast<const uint8_t*>(_mapping + header().bitmapOffset)[frame / 8] & (1 << (frame % 8));
+    };
+
+private:
+    const char*     _mapping;
+    uint_fast64_t   _bytes;
+
+    /// Each page ID has to be a frame in [1, blockCount) marked unused, and each unused frame has to occur exactly once.
+    bool consistent() const {
+        const Header& snapshot = header();
+        if (snapshot.pageIDBytes != sizeof(uint16_t) && snapshot.pageIDBytes != sizeof(uint32_t) && snapshot.pageIDBytes != sizeof(uint64_t)) return false;
+
+        uint_fast64_t unusedFrames = 0;
+        for (uint_fast64_t frame = 1; frame < snapshot.blockCount; frame++) {
+            if (frameUnused(frame)) unusedFrames++;
+        }
+        if (unusedFrames != snapshot.freePageCount) return false;
+
+        std::vector<bool> listed(snapshot.blockCount, false);
+        for (uint_fast64_t entry = 0; entry < snapshot.freePageCount; entry++) {
+            uint_fast64_t pageID = pageIDAt(entry);
+            if (pageID < 1 || pageID >= snapshot.blockCount || !frameUnused(pageID) || listed[pageID]) return false;
+            listed[pageID] = true;
+        }
+        return true;
+    };
+
+    inline uint_fast64_t pageIDAt(uint_fast64_t entry) const {
+        const char* pageID = _mapping + header().pageIDsOffset + entry * header().pageIDBytes;
+        switch (header().pageIDBytes) {
+            case sizeof(uint16_t):
+                return *reinterpret_cast<const uint16_t*>(pageID);
+            case sizeof(uint32_t):
+                return *reinterpret_cast<const uint32_t*>(pageID);
+            default:
+                return *reinterpret_cast<const uint64_t*>(pageID);
+        }
+    };
+
+    static uint_fast64_t alignedOffset(uint_fast64_t offset) {
+        return (offset + 63) / 64 * 64;
+    };
+};
+
+#endif //ZERO_DETAILS_EVALUATION_FREE_LIST_SNAPSHOT_HPP
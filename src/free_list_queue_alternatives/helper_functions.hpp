@@ -4,15 +4,19 @@
 #include "config.hpp"
 
 thread_local bool seed_initialized;
-thread_local uint32_t seed_0;
+thread_local uint64_t seed_0;
 
+/// A random block in [1, block_count) drawn from a 64 bit xorshift* generator (mapped to the range by a multiply-shift).
 inline uint_fast32_t fast_random() {
     if (!seed_initialized) {
-        seed_0 = std::random_device{}();
+        seed_0 = (uint64_t(std::random_device{}()) << 32 | std::random_device{}()) | 1;
         seed_initialized = true;
     }
-    seed_0 = 214013 * seed_0 + 2531011;
-    return ((seed_0 >> 16 & 0x7FFF) % (block_count - 1)) + 1;
+    seed_0 ^= seed_0 >> 12;
+    seed_0 ^= seed_0 << 25;
+    seed_0 ^= seed_0 >> 27;
+    uint64_t random = seed_0 * 2685821657736338717ull;
+    return uint_fast32_t((unsigned __int128)random * (block_count - 1) >> 64) + 1;
 }
 
 constexpr uint_fast32_t nextPowerOfTwo64(uint_fast32_t v) {
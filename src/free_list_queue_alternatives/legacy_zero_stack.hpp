@@ -4,31 +4,56 @@
 #include "free_list.hpp"
 #include "config.hpp"
 #include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
 
 #include "tatas.h"
 
-class LegacyZeroStack : public FreeList {
+template <typename PageID = uint_fast32_t>
+class LegacyZeroStack final : public FreeListOf<PageID> {
 private:
-    uint_fast32_t   _freelist[block_count];
-    uint_fast32_t   _approx_freelist_length;
-    tatas_lock      _freelist_lock;
+    FrameArray<PageID>          _freelist;
+    uint_fast32_t               _approx_freelist_length;
+    tatas_lock                  _freelist_lock;
+
+    /// The hash of the thread is cached instead of being looked up in thread-local storage on each acquisition.
+    struct Context : public FreeListContext {
+        uint_fast64_t   threadHash = tatas_lock::thread_hash();
+    };
 
 public:
     LegacyZeroStack() {
-        _freelist[0] = 1;
-        for (uint_fast32_t i = 1; i < block_count - 1; i++) {
-            _freelist[i] = i + 1;
+        _freelist.allocate(block_count, huge_pages);
+    };
+
+    // Each page ID links to the next one (and the last one to none):
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        for (uint_fast64_t i = first; i < last; i++) {
+            _freelist[pageIDs[i]] = i + 1 < length ? pageIDs[i + 1] : 0;
         }
-        _freelist[block_count - 1] = 0;
-        _approx_freelist_length = block_count - 1;
+    };
+
+    void init(const PageID* pageIDs, uint_fast64_t length) {
+        _freelist[0] = length > 0 ? pageIDs[0] : 0;
+        _approx_freelist_length = length;
+    };
+
+    std::unique_ptr<FreeListContext> createContext() {
+        return std::make_unique<Context>();
+    };
+
+    uint_fast64_t unallocatedBytes() {
+        return _freelist.size() * sizeof(PageID);
     };
 
     // https://github.com/iMax3060/zero/commit/f4f594b744687004f774690e0413663baf8502b0
-    void use(std::array<uint_fast32_t, block_count>& pageIDs, std::array<std::atomic_flag, block_count>& pageUnused) {
-        uint_fast32_t pageID;
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        uint_fast64_t threadHash = static_cast<Context&>(context).threadHash;
+        PageID pageID;
+        bool popSuccessful = true;
         while (true) {
             if (_approx_freelist_length > 0) {
-                _freelist_lock.acquire();
+                _freelist_lock.acquire(threadHash);
                 if (_approx_freelist_length > 0) {
                     pageID = _freelist[0];
 
@@ -39,28 +64,68 @@ public:
                         _freelist[0] = _freelist[pageID];
                     }
                     if (debug) std::cout << _approx_freelist_length << std::endl;
+                    TRACE_EVENT(POP_SUCCESS, pageID);
                     pageUnused[pageID].clear();
                     __asm__ __volatile__(""::"m" (pageID));
                     _freelist_lock.release();
                     break;
                 }
                 _freelist_lock.release();
-                std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+                simulate_work();
             }
 
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
+            popSuccessful = false;
             while (_approx_freelist_length < free_batch_size) {
                 pageID = fast_random();
                 if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
-                    _freelist_lock.acquire();
+                    _freelist_lock.acquire(threadHash);
                     ++_approx_freelist_length;
                     _freelist[pageID] = _freelist[0];
                     _freelist[0] = pageID;
                     _freelist_lock.release();
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
                     if (debug) std::cout << _approx_freelist_length << std::endl;
                 }
             }
+            TRACE_EVENT(REFILL_STOP, 0);
         }
+        return popSuccessful;
+    };
+
+    // The lock is acquired once per batch:
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        if (_approx_freelist_length == 0) return 0;
+        uint_fast32_t popped = 0;
+        _freelist_lock.acquire(static_cast<Context&>(context).threadHash);
+        while (popped < count && _approx_freelist_length > 0) {
+            PageID pageID = _freelist[0];
+            pageIDs[popped++] = pageID;
+            --_approx_freelist_length;
+            _freelist[0] = _approx_freelist_length == 0 ? 0 : _freelist[pageID];
+        }
+        _freelist_lock.release();
+        return popped;
+    };
+
+    // The batch is linked outside of the critical section and spliced onto the stack as a whole:
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        if (count == 0) return;
+        for (uint_fast32_t i = 0; i + 1 < count; i++) {
+            _freelist[pageIDs[i]] = pageIDs[i + 1];
+        }
+        _freelist_lock.acquire(static_cast<Context&>(context).threadHash);
+        _freelist[pageIDs[count - 1]] = _freelist[0];
+        _freelist[0] = pageIDs[0];
+        _approx_freelist_length += count;
+        _freelist_lock.release();
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _approx_freelist_length;
+        return true;
     };
 
 };
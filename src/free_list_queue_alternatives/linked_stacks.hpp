@@ -0,0 +1,143 @@
+#ifndef ZERO_DETAILS_EVALUATION_LINKED_STACKS_HPP
+#define ZERO_DETAILS_EVALUATION_LINKED_STACKS_HPP
+
+#include "config.hpp"
+#include "frame_array.hpp"
+#include "../contention_counters.hpp"
+
+#include "tatas.h"
+
+#include <atomic>
+#include <memory>
+
+/**\brief Stacks of page IDs, each with its own lock, sharing one array of links.
+ *
+ * The stacks are linked like the one of \c LegacyZeroStack, but as a page can
+ * only be in one of the stacks, all of them use the same array of links
+ * indexed by page ID. The stacks are on separate cache lines. Their lengths
+ * can be read without holding their lock.
+ */
+template <typename PageID>
+class LinkedStacks {
+public:
+    LinkedStacks() : _count(0) {};
+
+    void allocate(uint_fast32_t count) {
+        _links.allocate(block_count, huge_pages);
+        _stacks.reset(new Stack[count]);
+        _count = count;
+    };
+
+    uint_fast32_t count() const {
+        return _count;
+    };
+
+    uint_fast64_t bytes() const {
+        return _links.size() * sizeof(PageID);
+    };
+
+    inline uint_fast32_t length(uint_fast32_t stack) const {
+        return _stacks[stack].length.load(std::memory_order_relaxed);
+    };
+
+    uint_fast64_t totalLength() const {
+        uint_fast64_t length = 0;
+        for (uint_fast32_t stack = 0; stack < _count; stack++) {
+            length += this->length(stack);
+        }
+        return length;
+    };
+
+    /// Sets the next page of a page which isn't in any of the stacks yet.
+    inline void link(PageID pageID, PageID next) {
+        _links[pageID] = next;
+    };
+
+    /// Replaces the stack by the \c length linked pages starting at \c head (only while no thread uses the stacks).
+    void reset(uint_fast32_t stack, PageID head, uint_fast32_t length) {
+        _stacks[stack].head = head;
+        _stacks[stack].length = length;
+    };
+
+    inline bool pop(uint_fast32_t stack, uint_fast64_t threadHash, PageID& pageID) {
+        return pop(stack, threadHash, &pageID, 1) == 1;
+    };
+
+    /// Pops up to \c count pages acquiring the lock once and returns the number of popped ones.
+    inline uint_fast32_t pop(uint_fast32_t stack, uint_fast64_t threadHash, PageID* pageIDs, uint_fast32_t count) {
+        Stack& from = _stacks[stack];
+        if (from.length.load(std::memory_order_relaxed) == 0) return 0;
+        from.lock.acquire(threadHash);
+        uint_fast32_t length = from.length.load(std::memory_order_relaxed);
+        uint_fast32_t popped = 0;
+        while (popped < count && popped < length) {
+            pageIDs[popped] = from.head;
+            from.head = _links[from.head];
+            popped++;
+        }
+        from.length.store(length - popped, std::memory_order_relaxed);
+        from.lock.release();
+        return popped;
+    };
+
+    /// Pushes the \c count pages linked from \c first to \c last (linked outside of the critical section).
+    inline void push(uint_fast32_t stack, uint_fast64_t threadHash, PageID first, PageID last, uint_fast32_t count) {
+        Stack& to = _stacks[stack];
+        to.lock.acquire(threadHash);
+        _links[last] = to.head;
+        to.head = first;
+        to.length.store(to.length.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        to.lock.release();
+    };
+
+    /// Pushes the \c count pages after linking them in the given order.
+    inline void push(uint_fast32_t stack, uint_fast64_t threadHash, const PageID* pageIDs, uint_fast32_t count) {
+        if (count == 0) return;
+        for (uint_fast32_t i = 0; i + 1 < count; i++) {
+            _links[pageIDs[i]] = pageIDs[i + 1];
+        }
+        push(stack, threadHash, pageIDs[0], pageIDs[count - 1], count);
+    };
+
+    /**\brief Moves half of the pages of the \c victim stack to the \c thief stack except for one, which is returned.
+     *
+     * @return \c false if the \c victim stack was empty.
+     */
+    bool steal(uint_fast32_t victim, uint_fast32_t thief, uint_fast64_t threadHash, PageID& pageID) {
+        Stack& from = _stacks[victim];
+        if (from.length.load(std::memory_order_relaxed) == 0) return false;
+        from.lock.acquire(threadHash);
+        uint_fast32_t length = from.length.load(std::memory_order_relaxed);
+        if (length == 0) {
+            from.lock.release();
+            return false;
+        }
+        uint_fast32_t stolen = (length + 1) / 2;
+        PageID first = from.head;
+        PageID last = first;
+        for (uint_fast32_t i = 1; i < stolen; i++) {
+            last = _links[last];
+        }
+        from.head = _links[last];
+        from.length.store(length - stolen, std::memory_order_relaxed);
+        from.lock.release();
+        CONTENTION_COUNT(STEALS, 1);
+
+        pageID = first;
+        if (stolen > 1) push(thief, threadHash, _links[first], last, stolen - 1);
+        return true;
+    };
+
+private:
+    struct alignas(64) Stack {
+        tatas_lock                  lock;
+        PageID                      head = 0;
+        std::atomic<uint_fast32_t>  length {0};
+    };
+
+    FrameArray<PageID>          _links;
+    std::unique_ptr<Stack[]>    _stacks;
+    uint_fast32_t               _count;
+};
+
+#endif //ZERO_DETAILS_EVALUATION_LINKED_STACKS_HPP
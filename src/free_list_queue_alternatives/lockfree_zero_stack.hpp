@@ -0,0 +1,149 @@
+#ifndef ZERO_DETAILS_EVALUATION_LOCKFREE_ZERO_STACK_HPP
+#define ZERO_DETAILS_EVALUATION_LOCKFREE_ZERO_STACK_HPP
+
+#include "free_list.hpp"
+#include "config.hpp"
+#include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
+#include "../contention_counters.hpp"
+
+#include <atomic>
+
+/**\brief The stack of \c LegacyZeroStack as a lock-free Treiber stack.
+ *
+ * The stack is linked through an array indexed by page ID like the one of
+ * Zero, so no nodes are allocated. The head is a single 64 bit word with the
+ * page ID of the top of the stack in its lower half (so the page IDs are
+ * limited to 32 bits) and a tag in its upper half. The tag is incremented by
+ * each successful CAS on the head, so a CAS fails if the top was popped and
+ * pushed again in the meantime (the ABA problem). Page ID 0 marks the empty
+ * stack.
+ *
+ * As each modification of the stack changes the head, the links read before a
+ * successful CAS on the head are still valid. Therefore, a batch of pages can
+ * be popped and a chain of pages linked beforehand can be pushed with a single
+ * CAS each.
+ */
+template <typename PageID = uint_fast32_t>
+class LockFreeZeroStack final : public FreeListOf<PageID> {
+private:
+    // The links can be overwritten by a push while a pop reads them (and fails its CAS afterwards):
+    FrameArray<std::atomic<PageID>>         _freelist;
+    alignas(64) std::atomic<uint64_t>       _head;
+    alignas(64) std::atomic<int_fast64_t>   _approx_freelist_length;
+
+    static inline PageID top(uint64_t head) {
+        return PageID(head & 0xFFFFFFFFull);
+    };
+
+    static inline uint64_t nextHead(uint64_t head, PageID top) {
+        return ((head >> 32) + 1) << 32 | uint64_t(top);
+    };
+
+public:
+    LockFreeZeroStack() : _head(0), _approx_freelist_length(0) {
+        _freelist.allocate(block_count, huge_pages);
+    };
+
+    // Each page ID links to the next one (and the last one to none):
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        for (uint_fast64_t i = first; i < last; i++) {
+            _freelist[pageIDs[i]].store(i + 1 < length ? pageIDs[i + 1] : 0, std::memory_order_relaxed);
+        }
+    };
+
+    void init(const PageID* pageIDs, uint_fast64_t length) {
+        _head = length > 0 ? uint64_t(pageIDs[0]) : 0;
+        _approx_freelist_length = length;
+    };
+
+    uint_fast64_t unallocatedBytes() {
+        return _freelist.size() * sizeof(PageID);
+    };
+
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        PageID pageID;
+        bool popSuccessful = true;
+        // The control flow (and therefore the simulated work) is the one of LegacyZeroStack::use():
+        while (true) {
+            if (_approx_freelist_length.load(std::memory_order_relaxed) > 0) {
+                if (pop(&pageID, 1) == 1) {
+                    if (debug) std::cout << _approx_freelist_length << std::endl;
+                    TRACE_EVENT(POP_SUCCESS, pageID);
+                    pageUnused[pageID].clear();
+                    __asm__ __volatile__(""::"m" (pageID));
+                    break;
+                }
+                simulate_work();
+            }
+
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
+            popSuccessful = false;
+            while (_approx_freelist_length.load(std::memory_order_relaxed) < int_fast64_t(free_batch_size)) {
+                pageID = fast_random();
+                if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
+                    push(pageID, pageID, 1);
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
+                    if (debug) std::cout << _approx_freelist_length << std::endl;
+                }
+            }
+            TRACE_EVENT(REFILL_STOP, 0);
+        }
+        return popSuccessful;
+    };
+
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        return pop(pageIDs, count);
+    };
+
+    // The batch is linked before it is spliced onto the stack as a whole:
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        if (count == 0) return;
+        for (uint_fast32_t i = 0; i + 1 < count; i++) {
+            _freelist[pageIDs[i]].store(pageIDs[i + 1], std::memory_order_relaxed);
+        }
+        push(pageIDs[0], pageIDs[count - 1], count);
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _approx_freelist_length.load(std::memory_order_relaxed);
+        return true;
+    };
+
+private:
+    /// Pops up to \c count pages with one successful CAS and returns the number of popped ones.
+    inline uint_fast32_t pop(PageID* pageIDs, uint_fast32_t count) {
+        uint64_t head = _head.load(std::memory_order_acquire);
+        while (true) {
+            uint_fast32_t popped = 0;
+            PageID next = top(head);
+            while (popped < count && next != 0) {
+                pageIDs[popped++] = next;
+                next = _freelist[next].load(std::memory_order_relaxed);
+            }
+            if (popped == 0) return 0;
+            if (_head.compare_exchange_weak(head, nextHead(head, next), std::memory_order_acquire, std::memory_order_acquire)) {
+                _approx_freelist_length.fetch_sub(popped, std::memory_order_relaxed);
+                return popped;
+            }
+            CONTENTION_COUNT(DEQUEUE_CAS_FAILURES, 1);
+        }
+    };
+
+    /// Pushes the \c count pages linked from \c first to \c last with one successful CAS.
+    inline void push(PageID first, PageID last, uint_fast32_t count) {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        while (true) {
+            _freelist[last].store(top(head), std::memory_order_relaxed);
+            if (_head.compare_exchange_weak(head, nextHead(head, first), std::memory_order_release, std::memory_order_relaxed)) break;
+            CONTENTION_COUNT(ENQUEUE_CAS_FAILURES, 1);
+        }
+        _approx_freelist_length.fetch_add(count, std::memory_order_relaxed);
+    };
+
+};
+
+#endif //ZERO_DETAILS_EVALUATION_LOCKFREE_ZERO_STACK_HPP
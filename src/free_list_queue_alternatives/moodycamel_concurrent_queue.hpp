@@ -4,45 +4,78 @@
 #include "free_list.hpp"
 #include "config.hpp"
 #include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
 
 #include "concurrentqueue/concurrentqueue.h"
 
-class MoodycamelConcurrentQueue : public FreeList {
+template <typename PageID = uint_fast32_t>
+class MoodycamelConcurrentQueue final : public FreeListOf<PageID> {
 private:
-    moodycamel::ConcurrentQueue<uint_fast32_t> _freelist;
-//    static thread_local moodycamel::ProducerToken producer_token = moodycamel::ProducerToken(_freelist);
-//    static thread_local moodycamel::ConsumerToken consumer_token = moodycamel::ProducerToken(_freelist);
+    moodycamel::ConcurrentQueue<PageID> _freelist;
+
+    struct Context : public FreeListContext {
+        moodycamel::ProducerToken   producerToken;
+        moodycamel::ConsumerToken   consumerToken;
+
+        Context(moodycamel::ConcurrentQueue<PageID>& queue) : producerToken(queue), consumerToken(queue) {};
+    };
 
 public:
-    MoodycamelConcurrentQueue() : _freelist(block_count - 1, thread_count, 0) {
-        for (uint_fast32_t i = 1; i < block_count; i++) {
-            _freelist.try_enqueue(i);
-        }
+    // Each worker thread and each of the --init_threads filling the queue has its own explicit producer:
+    MoodycamelConcurrentQueue() : _freelist(block_count - 1, thread_count + init_thread_count, 0) {};
+
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        _freelist.enqueue_bulk(static_cast<Context&>(context).producerToken, pageIDs + first, last - first);
+    };
+
+    std::unique_ptr<FreeListContext> createContext() {
+        return std::make_unique<Context>(_freelist);
     };
 
     // https://github.com/cameron314/concurrentqueue
-    void use(std::array<uint_fast32_t, block_count>& pageIDs, std::array<std::atomic_flag, block_count>& pageUnused) {
-        uint_fast32_t pageID;
-        bool popSuccessful = _freelist.try_dequeue(/*consumer_token, */pageID);
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        Context& tokens = static_cast<Context&>(context);
+        PageID pageID;
+        bool popSuccessful = _freelist.try_dequeue(tokens.consumerToken, pageID);
         if (popSuccessful) {
+            TRACE_EVENT(POP_SUCCESS, pageID);
             if (debug) std::cout << _freelist.size_approx() << std::endl;
             pageUnused[pageID].clear();
-            std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+            simulate_work();
             __asm__ __volatile__(""::"m" (pageID));
         } else {
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
             while (_freelist.size_approx() < free_batch_size) {
                 pageID = fast_random();
                 if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
                     if (move) {
-                        _freelist.enqueue(/*producer_token, */std::move(pageID));
+                        _freelist.enqueue(tokens.producerToken, std::move(pageID));
                     } else {
-                        _freelist.enqueue(/*producer_token, */pageID);
+                        _freelist.enqueue(tokens.producerToken, pageID);
                     }
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
                     if (debug) std::cout << _freelist.size_approx() << std::endl;
                 }
             }
+            TRACE_EVENT(REFILL_STOP, 0);
         }
+        return popSuccessful;
+    };
+
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        return uint_fast32_t(_freelist.try_dequeue_bulk(static_cast<Context&>(context).consumerToken, pageIDs, count));
+    };
+
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        _freelist.enqueue_bulk(static_cast<Context&>(context).producerToken, pageIDs, count);
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _freelist.size_approx();
+        return true;
     };
 
 };
@@ -4,34 +4,45 @@
 #include "free_list.hpp"
 #include "config.hpp"
 #include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
 
 #include <atomic>
 #include "mpmc_queue.h"
 
-class MPMCBoundedQueue : public FreeList {
+template <typename PageID = uint_fast32_t>
+class MPMCBoundedQueue final : public FreeListOf<PageID> {
 private:
-    mpmc_bounded_queue<uint_fast32_t>   _freelist;
+    mpmc_bounded_queue<PageID>          _freelist;
     std::atomic<uint_fast32_t>          _freelist_size;
 
 public:
-    MPMCBoundedQueue() : _freelist(nextPowerOfTwo64(block_count - 1)) {
-        for (uint_fast32_t i = 1; i < block_count; i++) {
-            _freelist.enqueue(i);
-            _freelist_size++;
-        }
+    MPMCBoundedQueue() : _freelist(nextPowerOfTwo64(block_count - 1)) {};
+
+    // The i-th page ID is stored in the i-th cell of the ring buffer:
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        _freelist.prefill(first, pageIDs + first, last - first);
+    };
+
+    void init(const PageID* pageIDs, uint_fast64_t length) {
+        _freelist.publish_prefilled(length);
+        _freelist_size = length;
     };
 
     // http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
-    void use(std::array<uint_fast32_t, block_count>& pageIDs, std::array<std::atomic_flag, block_count>& pageUnused) {
-        uint_fast32_t pageID;
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        PageID pageID;
         bool popSuccessful = _freelist.dequeue(pageID);
         if (popSuccessful) {
+            TRACE_EVENT(POP_SUCCESS, pageID);
             if (debug) std::cout << _freelist_size << std::endl;
             _freelist_size--;
             pageUnused[pageID].clear();
-            std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+            simulate_work();
             __asm__ __volatile__(""::"m" (pageID));
         } else {
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
             while (_freelist_size < free_batch_size) {
                 pageID = fast_random();
                 if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
@@ -41,11 +52,32 @@ public:
                         _freelist.enqueue(pageID);
                     }
                     _freelist_size++;
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
                     if (debug) std::cout << _freelist_size << std::endl;
                 }
             }
+            TRACE_EVENT(REFILL_STOP, 0);
         }
+        return popSuccessful;
+    };
+
+    // The cells of a batch are reserved with a single update of the position:
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        uint_fast32_t popped = uint_fast32_t(_freelist.dequeue_bulk(pageIDs, count));
+        _freelist_size -= popped;
+        return popped;
+    };
+
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        // The ring buffer can hold all the page IDs, so it's only full until the cells dequeued last are released:
+        while (!_freelist.enqueue_bulk(pageIDs, count)) {}
+        _freelist_size += count;
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _freelist_size;
+        return true;
     };
 
 };
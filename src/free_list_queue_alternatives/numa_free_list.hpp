@@ -0,0 +1,234 @@
+#ifndef ZERO_DETAILS_EVALUATION_NUMA_FREE_LIST_HPP
+#define ZERO_DETAILS_EVALUATION_NUMA_FREE_LIST_HPP
+
+#include "free_list.hpp"
+#include "config.hpp"
+#include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
+#include "linked_stacks.hpp"
+#include "../numa_topology.hpp"
+#include "../contention_counters.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+/**\brief A free list with a partition per NUMA node where threads prefer the frames of their own node.
+ *
+ * Each frame has a home node, which is the node its memory is located on. The
+ * frames are assigned to the nodes in contiguous ranges of page IDs, as if the
+ * buffer pool was interleaved in equal parts. The partitions are
+ * \c LinkedStacks and contain only free frames of their node, so a page is
+ * always pushed to the partition of its home node.
+ *
+ * A thread pops from the partition of the node it runs on (so it should be
+ * pinned using \c --placement). If that partition is empty, the
+ * \c numa_fallback policy decides whether to take a frame of a remote
+ * partition (the nearest or the largest one) or to refill the local one by
+ * evicting frames of the own node. The refills of a thread always evict
+ * frames of its own node.
+ */
+template <typename PageID = uint_fast32_t>
+class NUMAFreeList final : public FreeListOf<PageID> {
+private:
+    struct Context : public FreeListContext {
+        uint_fast32_t               node;
+        uint_fast64_t               randomState;
+        uint_fast64_t               threadHash = tatas_lock::thread_hash();
+        // The chains of pages per node built by pushBulk() and fill():
+        std::vector<PageID>         firsts;
+        std::vector<PageID>         lasts;
+        std::vector<uint_fast32_t>  counts;
+
+        Context(uint_fast32_t node, uint_fast32_t nodeCount) : node(node), randomState(threadHash | 1),
+                                                               firsts(nodeCount), lasts(nodeCount), counts(nodeCount) {};
+    };
+
+    NUMATopology                                _topology;
+    LinkedStacks<PageID>                        _partitions;
+    std::vector<std::vector<uint_fast32_t>>     _remote_nodes;      // the other nodes of each node, nearest first
+    uint_fast32_t                               _refill_target;
+
+public:
+    NUMAFreeList() : _topology(virtual_nodes) {
+        _partitions.allocate(_topology.nodeCount());
+        for (uint_fast32_t node = 0; node < _topology.nodeCount(); node++) {
+            _remote_nodes.push_back(_topology.nodesByDistance(node));
+        }
+        _refill_target = refillTarget(_topology.nodeCount());
+    };
+
+    /// The length up to which a thread refills the partition of its node (its share of the \c free_batch_size).
+    static uint_fast32_t refillTarget(uint_fast32_t nodeCount) {
+        return std::max(uint_fast32_t(1), free_batch_size / nodeCount);
+    };
+
+    std::unique_ptr<FreeListContext> createContext() {
+        return std::make_unique<Context>(_topology.nodeOfThisThread(), _topology.nodeCount());
+    };
+
+    uint_fast64_t unallocatedBytes() {
+        return _partitions.bytes();
+    };
+
+    // Each thread pushes a chain per node with the pages of its range:
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        Context& numaContext = static_cast<Context&>(context);
+        for (uint_fast64_t i = first; i < last; i++) {
+            addToChain(numaContext, pageIDs[i]);
+        }
+        pushChains(numaContext);
+    };
+
+    void init(const PageID* pageIDs, uint_fast64_t length) {};
+
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        Context& numaContext = static_cast<Context&>(context);
+        PageID pageID;
+        if (_partitions.pop(numaContext.node, numaContext.threadHash, pageID) || popRemote(numaContext, pageID)) {
+            if (debug) std::cout << _partitions.length(numaContext.node) << std::endl;
+            TRACE_EVENT(POP_SUCCESS, pageID);
+            pageUnused[pageID].clear();
+            simulate_work();
+            __asm__ __volatile__(""::"m" (pageID));
+            return true;
+        } else {
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
+            // Only frames of the own node are evicted, linked outside of the critical section and pushed at once:
+            uint_fast64_t begin = nodeBegin(numaContext.node);
+            uint_fast64_t frames = nodeBegin(numaContext.node + 1) - begin;
+            uint_fast32_t target = uint_fast32_t(std::min(uint_fast64_t(_refill_target), frames));
+            PageID first = 0;
+            PageID last = 0;
+            uint_fast32_t victims = 0;
+            // The other threads might hold the free frames of the node, so the refill gives up after many misses (and the next call pops again, remotely if the fallback allows it):
+            uint_fast64_t misses = 0;
+            while (_partitions.length(numaContext.node) + victims < target && misses < 16 * frames) {
+                pageID = PageID(begin + localRandom(numaContext, frames));
+                if (pageUnused[pageID].test_and_set(std::memory_order_consume)) {
+                    misses++;
+                } else {
+                    misses = 0;
+                    if (victims == 0) {
+                        last = pageID;
+                    } else {
+                        _partitions.link(pageID, first);
+                    }
+                    first = pageID;
+                    victims++;
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
+                }
+            }
+            if (victims > 0) _partitions.push(numaContext.node, numaContext.threadHash, first, last, victims);
+            if (debug) std::cout << _partitions.length(numaContext.node) << std::endl;
+            TRACE_EVENT(REFILL_STOP, 0);
+            return false;
+        }
+    };
+
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        Context& numaContext = static_cast<Context&>(context);
+        uint_fast32_t popped = _partitions.pop(numaContext.node, numaContext.threadHash, pageIDs, count);
+        if (popped == 0 && popRemote(numaContext, pageIDs[0])) popped = 1;
+        return popped;
+    };
+
+    // The pages are pushed to the partitions of their home nodes with one push per node:
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        Context& numaContext = static_cast<Context&>(context);
+        for (uint_fast32_t i = 0; i < count; i++) {
+            addToChain(numaContext, pageIDs[i]);
+        }
+        pushChains(numaContext);
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _partitions.totalLength();
+        return true;
+    };
+
+private:
+    /// The first frame of the node (the frames of the nodes are equal parts of [1, block_count)).
+    inline uint_fast64_t nodeBegin(uint_fast32_t node) const {
+        return 1 + uint_fast64_t(block_count - 1) * node / _topology.nodeCount();
+    };
+
+    inline uint_fast32_t homeNode(PageID pageID) const {
+        uint_fast32_t node = uint_fast32_t(uint_fast64_t(pageID - 1) * _topology.nodeCount() / (block_count - 1));
+        while (node + 1 < _topology.nodeCount() && nodeBegin(node + 1) <= pageID) node++;
+        while (node > 0 && nodeBegin(node) > pageID) node--;
+        return node;
+    };
+
+    /// A random offset in [0, range) drawn from the xorshift* generator of the thread.
+    inline uint_fast64_t localRandom(Context& context, uint_fast64_t range) {
+        context.randomState ^= context.randomState >> 12;
+        context.randomState ^= context.randomState << 25;
+        context.randomState ^= context.randomState >> 27;
+        return uint_fast64_t((unsigned __int128)(context.randomState * 2685821657736338717ull) * range >> 64);
+    };
+
+    inline void addToChain(Context& context, PageID pageID) {
+        uint_fast32_t node = homeNode(pageID);
+        if (context.counts[node] == 0) {
+            context.lasts[node] = pageID;
+        } else {
+            _partitions.link(pageID, context.firsts[node]);
+        }
+        context.firsts[node] = pageID;
+        context.counts[node]++;
+    };
+
+    inline void pushChains(Context& context) {
+        for (uint_fast32_t node = 0; node < _topology.nodeCount(); node++) {
+            if (context.counts[node] > 0) {
+                _partitions.push(node, context.threadHash, context.firsts[node], context.lasts[node], context.counts[node]);
+                context.counts[node] = 0;
+            }
+        }
+    };
+
+    /// Pops a frame of a remote node if the \c numa_fallback policy allows it.
+    bool popRemote(Context& context, PageID& pageID) {
+        const std::vector<uint_fast32_t>& remoteNodes = _remote_nodes[context.node];
+        switch (numa_fallback) {
+            case NEAREST_NODE: {
+                for (uint_fast32_t node : remoteNodes) {
+                    if (_partitions.pop(node, context.threadHash, pageID)) {
+                        CONTENTION_COUNT(REMOTE_POPS, 1);
+                        return true;
+                    }
+                }
+                return false;
+            }
+            case LARGEST_NODE: {
+                // The lengths can change before the pop, so the nodes are retried until all were empty:
+                while (true) {
+                    uint_fast32_t largestNode = context.node;
+                    uint_fast32_t largest = 0;
+                    for (uint_fast32_t node : remoteNodes) {
+                        uint_fast32_t length = _partitions.length(node);
+                        if (length > largest) {
+                            largestNode = node;
+                            largest = length;
+                        }
+                    }
+                    if (largest == 0) return false;
+                    if (_partitions.pop(largestNode, context.threadHash, pageID)) {
+                        CONTENTION_COUNT(REMOTE_POPS, 1);
+                        return true;
+                    }
+                }
+            }
+            case LOCAL_ONLY:
+            default:
+                return false;
+        }
+    };
+
+};
+
+#endif //ZERO_DETAILS_EVALUATION_NUMA_FREE_LIST_HPP
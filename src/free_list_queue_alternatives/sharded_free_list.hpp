@@ -0,0 +1,192 @@
+#ifndef ZERO_DETAILS_EVALUATION_SHARDED_FREE_LIST_HPP
+#define ZERO_DETAILS_EVALUATION_SHARDED_FREE_LIST_HPP
+
+#include "free_list.hpp"
+#include "config.hpp"
+#include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
+#include "linked_stacks.hpp"
+#include "../contention_counters.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+/**\brief A free list with a stack per shard where threads steal from other shards if theirs runs empty.
+ *
+ * Each worker thread is assigned a shard by its thread index (modulo the
+ * number of shards, so the fill threads don't shift the assignment) where it
+ * pops its free pages and pushes the victims of its refills. The shards are
+ * \c LinkedStacks. A thread popping from its empty shard steals half of the
+ * pages of another shard, which is chosen according to the \c steal_policy.
+ * Only if there's nothing to steal, it refills its shard up to its share of
+ * the \c free_batch_size.
+ */
+template <typename PageID = uint_fast32_t>
+class ShardedFreeList final : public FreeListOf<PageID> {
+private:
+    struct Context : public FreeListContext {
+        uint_fast32_t   shard;
+        uint_fast32_t   nextVictim;
+        uint_fast64_t   randomState;
+        uint_fast64_t   threadHash = tatas_lock::thread_hash();
+
+        Context(uint_fast32_t shard) : shard(shard), nextVictim(shard), randomState(shard * 2685821657736338717ull + 1) {};
+    };
+
+    LinkedStacks<PageID>        _shards;
+    uint_fast32_t               _refill_target;
+
+public:
+    ShardedFreeList() {
+        _shards.allocate(shard_count ? shard_count : thread_count);
+        _refill_target = std::max(uint_fast32_t(1), free_batch_size / _shards.count());
+    };
+
+    // The fill threads don't use their context:
+    std::unique_ptr<FreeListContext> createContext() {
+        return std::make_unique<Context>(0);
+    };
+
+    std::unique_ptr<FreeListContext> createWorkerContext(uint_fast32_t threadIndex) {
+        return std::make_unique<Context>(threadIndex % _shards.count());
+    };
+
+    uint_fast64_t unallocatedBytes() {
+        return _shards.bytes();
+    };
+
+    // Each shard gets a contiguous part of the page IDs:
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        for (uint_fast64_t i = first; i < last; i++) {
+            uint_fast64_t shardEnd = shardBegin(shardOf(i, length) + 1, length);
+            _shards.link(pageIDs[i], i + 1 < shardEnd ? pageIDs[i + 1] : 0);
+        }
+    };
+
+    void init(const PageID* pageIDs, uint_fast64_t length) {
+        for (uint_fast32_t shard = 0; shard < _shards.count(); shard++) {
+            uint_fast64_t begin = shardBegin(shard, length);
+            uint_fast64_t end = shardBegin(shard + 1, length);
+            _shards.reset(shard, end > begin ? pageIDs[begin] : 0, uint_fast32_t(end - begin));
+        }
+    };
+
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        Context& shardContext = static_cast<Context&>(context);
+        PageID pageID;
+        if (_shards.pop(shardContext.shard, shardContext.threadHash, pageID) || steal(shardContext, pageID)) {
+            if (debug) std::cout << _shards.length(shardContext.shard) << std::endl;
+            TRACE_EVENT(POP_SUCCESS, pageID);
+            pageUnused[pageID].clear();
+            simulate_work();
+            __asm__ __volatile__(""::"m" (pageID));
+            return true;
+        } else {
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
+            // The victims are linked outside of the critical section and pushed onto the shard at once:
+            PageID first = 0;
+            PageID last = 0;
+            uint_fast32_t victims = 0;
+            while (_shards.length(shardContext.shard) + victims < _refill_target) {
+                pageID = fast_random();
+                if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
+                    if (victims == 0) {
+                        last = pageID;
+                    } else {
+                        _shards.link(pageID, first);
+                    }
+                    first = pageID;
+                    victims++;
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
+                }
+            }
+            if (victims > 0) _shards.push(shardContext.shard, shardContext.threadHash, first, last, victims);
+            if (debug) std::cout << _shards.length(shardContext.shard) << std::endl;
+            TRACE_EVENT(REFILL_STOP, 0);
+            return false;
+        }
+    };
+
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        Context& shardContext = static_cast<Context&>(context);
+        uint_fast32_t popped = _shards.pop(shardContext.shard, shardContext.threadHash, pageIDs, count);
+        if (popped == 0 && steal(shardContext, pageIDs[0])) popped = 1;
+        return popped;
+    };
+
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        Context& shardContext = static_cast<Context&>(context);
+        _shards.push(shardContext.shard, shardContext.threadHash, pageIDs, count);
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _shards.totalLength();
+        return true;
+    };
+
+private:
+    uint_fast64_t shardBegin(uint_fast32_t shard, uint_fast64_t length) const {
+        return length * shard / _shards.count();
+    };
+
+    uint_fast32_t shardOf(uint_fast64_t index, uint_fast64_t length) const {
+        uint_fast32_t shard = uint_fast32_t(index * _shards.count() / length);
+        while (shardBegin(shard + 1, length) <= index) shard++;
+        while (shardBegin(shard, length) > index) shard--;
+        return shard;
+    };
+
+    /**\brief Steals half of the pages of another shard, returns one of them and pushes the others onto the own shard.
+     *
+     * Each other shard is tried at most once (in the order of the policy)
+     * before the steal fails.
+     */
+    bool steal(Context& context, PageID& pageID) {
+        for (uint_fast32_t attempt = 1; attempt < _shards.count(); attempt++) {
+            uint_fast32_t victim = chooseVictim(context);
+            if (victim == context.shard) break;
+            if (_shards.steal(victim, context.shard, context.threadHash, pageID)) return true;
+        }
+        CONTENTION_COUNT(STEAL_FAILURES, 1);
+        return false;
+    };
+
+    /// Returns the own shard if there's no other shard to steal from.
+    uint_fast32_t chooseVictim(Context& context) {
+        if (_shards.count() == 1) return context.shard;
+        switch (steal_policy) {
+            case RANDOM_VICTIM: {
+                context.randomState ^= context.randomState >> 12;
+                context.randomState ^= context.randomState << 25;
+                context.randomState ^= context.randomState >> 27;
+                uint_fast32_t victim = uint_fast32_t((unsigned __int128)(context.randomState * 2685821657736338717ull) * (_shards.count() - 1) >> 64);
+                return victim >= context.shard ? victim + 1 : victim;
+            }
+            case ROUND_ROBIN: {
+                context.nextVictim = (context.nextVictim + 1) % _shards.count();
+                if (context.nextVictim == context.shard) context.nextVictim = (context.nextVictim + 1) % _shards.count();
+                return context.nextVictim;
+            }
+            case LARGEST_FIRST:
+            default: {
+                uint_fast32_t victim = context.shard;
+                uint_fast32_t largest = 0;
+                for (uint_fast32_t shard = 0; shard < _shards.count(); shard++) {
+                    uint_fast32_t length = _shards.length(shard);
+                    if (shard != context.shard && length > largest) {
+                        victim = shard;
+                        largest = length;
+                    }
+                }
+                return victim;
+            }
+        }
+    };
+
+};
+
+#endif //ZERO_DETAILS_EVALUATION_SHARDED_FREE_LIST_HPP
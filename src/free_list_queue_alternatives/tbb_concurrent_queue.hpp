@@ -4,30 +4,45 @@
 #include "free_list.hpp"
 #include "config.hpp"
 #include "helper_functions.hpp"
+#include "work_simulation.hpp"
+#include "../event_tracer.hpp"
+#include "../allocation_counters.hpp"
+#include "../pool_allocator.hpp"
 
+#include <tbb/cache_aligned_allocator.h>
 #include <tbb/concurrent_queue.h>
 
-class TBBConcurrentQueue : public FreeList {
+/// The allocator of the TBB queues with counted allocations (as the scalable allocator of TBB doesn't use malloc).
+template <typename PageID>
+using CountedCacheAlignedAllocator = CountingAllocator<PageID, tbb::cache_aligned_allocator<PageID>>;
+
+template <typename PageID = uint_fast32_t, typename Allocator = tbb::cache_aligned_allocator<PageID>>
+class TBBConcurrentQueue final : public FreeListOf<PageID> {
 private:
-    tbb::concurrent_queue<uint_fast32_t>    _freelist;
+    tbb::concurrent_queue<PageID, Allocator>        _freelist;
 
 public:
-    TBBConcurrentQueue() {
-        for (uint_fast32_t i = 1; i < block_count; i++) {
-            _freelist.push(i);
+    TBBConcurrentQueue() {};
+
+    void fill(FreeListContext& context, const PageID* pageIDs, uint_fast64_t length, uint_fast64_t first, uint_fast64_t last) {
+        for (uint_fast64_t i = first; i < last; i++) {
+            _freelist.push(pageIDs[i]);
         }
     };
 
     // https://software.intel.com/en-us/node/506200
-    void use(std::array<uint_fast32_t, block_count>& pageIDs, std::array<std::atomic_flag, block_count>& pageUnused) {
-        uint_fast32_t pageID;
+    bool use(FreeListContext& context, FrameArray<PageID>& pageIDs, FrameArray<std::atomic_flag>& pageUnused) {
+        PageID pageID;
         bool popSuccessful = _freelist.try_pop(pageID);
         if (popSuccessful) {
+            TRACE_EVENT(POP_SUCCESS, pageID);
             if (debug) std::cout << _freelist.unsafe_size() << std::endl;
             pageUnused[pageID].clear();
-            std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+            simulate_work();
             __asm__ __volatile__(""::"m" (pageID));
         } else {
+            TRACE_EVENT(POP_FAILURE, 0);
+            TRACE_EVENT(REFILL_START, 0);
             while (_freelist.unsafe_size() < free_batch_size) {
                 pageID = fast_random();
                 if (!pageUnused[pageID].test_and_set(std::memory_order_consume)) {
@@ -36,11 +51,33 @@ public:
                     } else {
                         _freelist.push(pageID);
                     }
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+                    TRACE_EVENT(ENQUEUE, pageID);
+                    simulate_work();
                     if (debug) std::cout << _freelist.unsafe_size() << std::endl;
                 }
             }
+            TRACE_EVENT(REFILL_STOP, 0);
+        }
+        return popSuccessful;
+    };
+
+    uint_fast32_t popBulk(FreeListContext& context, PageID* pageIDs, uint_fast32_t count) {
+        uint_fast32_t popped = 0;
+        while (popped < count && _freelist.try_pop(pageIDs[popped])) {
+            popped++;
         }
+        return popped;
+    };
+
+    void pushBulk(FreeListContext& context, const PageID* pageIDs, uint_fast32_t count) {
+        for (uint_fast32_t i = 0; i < count; i++) {
+            _freelist.push(pageIDs[i]);
+        }
+    };
+
+    bool approximateLength(int_fast64_t& length) {
+        length = _freelist.unsafe_size();
+        return true;
     };
 
 };
@@ -0,0 +1,47 @@
+#ifndef ZERO_DETAILS_EVALUATION_WORK_SIMULATION_HPP
+#define ZERO_DETAILS_EVALUATION_WORK_SIMULATION_HPP
+
+#include "config.hpp"
+#include "../benchmark_clock.hpp"
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+// The page size of Zero:
+constexpr uint_fast32_t work_page_size = 8192;
+
+alignas(64) thread_local std::array<uint64_t, work_page_size / sizeof(uint64_t)> work_page;
+
+/**\brief Simulates the work done between two free list operations for \c work_time_ns.
+ *
+ * - SPIN:  busy-waits on the (calibrated) \c BenchmarkClock, so even short work times are hit
+ * - READ:  reads the first \c work_bytes of a page-sized buffer, then busy-waits for the remaining time
+ * - WRITE: writes the first \c work_bytes of a page-sized buffer, then busy-waits for the remaining time
+ * - SLEEP: \c std::this_thread::sleep_for as before (a syscall with a granularity of tens of microseconds)
+ */
+inline void simulate_work() {
+    if (work_model == SLEEP) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(work_time_ns));
+        return;
+    }
+
+    uint_fast64_t deadline = BenchmarkClock::now() + uint_fast64_t(double(work_time_ns) * BenchmarkClock::ticksPerNS());
+
+    if (work_model == READ) {
+        uint64_t sum = 0;
+        for (uint_fast32_t i = 0; i < work_bytes / sizeof(uint64_t); i++) {
+            sum += work_page[i];
+        }
+        __asm__ __volatile__(""::"r" (sum));
+    } else if (work_model == WRITE) {
+        for (uint_fast32_t i = 0; i < work_bytes / sizeof(uint64_t); i++) {
+            work_page[i] = i;
+        }
+        __asm__ __volatile__(""::"m" (work_page));
+    }
+
+    while (BenchmarkClock::now() < deadline) {}
+}
+
+#endif //ZERO_DETAILS_EVALUATION_WORK_SIMULATION_HPP
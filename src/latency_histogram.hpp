@@ -0,0 +1,110 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_LATENCY_HISTOGRAM_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**\brief A log-bucketed latency histogram in the style of HdrHistogram.
+ *
+ * Each power of two is split into \c subBucketCount linear sub-buckets, so
+ * every recorded value is reproduced with a relative error below
+ * \f$2^{-subBucketBits}\f$ (about 3%) over the whole 64 bit range. Recording
+ * a value is a count-leading-zeros, a shift and a non-atomic increment, which
+ * is why each thread has to record into its own instance and the instances
+ * have to be merged after the threads completed.
+ */
+class LatencyHistogram {
+public:
+    static constexpr uint_fast32_t subBucketBits = 5;
+    static constexpr uint_fast32_t subBucketCount = 1 << subBucketBits;
+    static constexpr uint_fast32_t bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    void reset() {
+        counts.fill(0);
+        totalCount = 0;
+        totalSum = 0;
+        minValue = UINT_FAST64_MAX;
+        maxValue = 0;
+    }
+
+    inline void record(uint_fast64_t value) {
+        counts[bucketIndex(value)]++;
+        totalCount++;
+        totalSum += value;
+        if (value < minValue) minValue = value;
+        if (value > maxValue) maxValue = value;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (uint_fast32_t i = 0; i < bucketCount; i++) {
+            counts[i] += other.counts[i];
+        }
+        totalCount += other.totalCount;
+        totalSum += other.totalSum;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    uint_fast64_t count() const {
+        return totalCount;
+    }
+
+    uint_fast64_t min() const {
+        return totalCount ? minValue : 0;
+    }
+
+    uint_fast64_t max() const {
+        return maxValue;
+    }
+
+    double mean() const {
+        return totalCount ? double(totalSum) / double(totalCount) : 0.0;
+    }
+
+    /// The highest value equivalent to the value at the given percentile (0.0 to 100.0).
+    uint_fast64_t percentile(double percentile) const {
+        if (totalCount == 0) return 0;
+
+        uint_fast64_t rank = uint_fast64_t(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * double(totalCount)));
+        if (rank == 0) rank = 1;
+
+        uint_fast64_t cumulativeCount = 0;
+        for (uint_fast32_t i = 0; i < bucketCount; i++) {
+            cumulativeCount += counts[i];
+            if (cumulativeCount >= rank) {
+                return std::clamp(bucketUpperBound(i), minValue, maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+private:
+    static inline uint_fast32_t bucketIndex(uint_fast64_t value) {
+        if (value < subBucketCount) return uint_fast32_t(value);
+
+        uint_fast32_t shift = uint_fast32_t(63 - __builtin_clzll(value)) - subBucketBits;
+        return (shift + 1) * subBucketCount + uint_fast32_t((value >> shift) - subBucketCount);
+    }
+
+    static uint_fast64_t bucketUpperBound(uint_fast32_t index) {
+        if (index < subBucketCount) return index;
+
+        uint_fast32_t shift = index / subBucketCount - 1;
+        uint_fast64_t subBucket = index % subBucketCount + subBucketCount;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+    std::array<uint_fast64_t, bucketCount>  counts;
+    uint_fast64_t                           totalCount;
+    uint_fast64_t                           totalSum;
+    uint_fast64_t                           minValue;
+    uint_fast64_t                           maxValue;
+};
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,113 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_NUMA_TOPOLOGY_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_NUMA_TOPOLOGY_HPP
+
+#include "thread_placement.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sched.h>
+
+/**\brief The NUMA nodes as exported in \c /sys/devices/system/node.
+ *
+ * The nodes are numbered densely (even if the IDs of the kernel aren't). If
+ * the nodes aren't available, all the CPUs belong to a single node. With
+ * virtual nodes, the online CPUs are split into that many nodes of
+ * consecutive CPUs (with a distance of 10 within and 20 between the nodes),
+ * so the NUMA-aware code can be tested on single-node machines.
+ */
+class NUMATopology {
+public:
+    explicit NUMATopology(uint_fast32_t virtualNodes = 0) : virtualTopology(virtualNodes > 0) {
+        if (virtualTopology) {
+            std::vector<uint_fast32_t> online;
+            for (const CPU& cpu : CPUTopology().all()) online.push_back(cpu.id);
+            std::sort(online.begin(), online.end());
+            for (uint_fast32_t i = 0; i < online.size(); i++) {
+                cpuNodes[online[i]] = uint_fast32_t(uint_fast64_t(i) * virtualNodes / online.size());
+            }
+            distances.assign(virtualNodes, std::vector<uint_fast32_t>(virtualNodes, 20));
+            for (uint_fast32_t node = 0; node < virtualNodes; node++) distances[node][node] = 10;
+            return;
+        }
+
+        std::vector<uint_fast32_t> nodeIDs;
+        try {
+            nodeIDs = parseCPUList(readLine("/sys/devices/system/node/online"));
+        } catch (std::logic_error& e) {}
+        if (nodeIDs.empty()) {
+            distances.assign(1, std::vector<uint_fast32_t>(1, 10));
+            return;
+        }
+
+        for (uint_fast32_t node = 0; node < nodeIDs.size(); node++) {
+            std::string directory = "/sys/devices/system/node/node" + std::to_string(nodeIDs[node]) + "/";
+            try {
+                for (uint_fast32_t cpu : parseCPUList(readLine(directory + "cpulist"))) cpuNodes[cpu] = node;
+            } catch (std::logic_error& e) {}
+
+            // The distances are listed for all the online nodes in the order of their IDs:
+            std::istringstream distanceList(readLine(directory + "distance"));
+            std::vector<uint_fast32_t> row;
+            uint_fast32_t distance;
+            while (distanceList >> distance) row.push_back(distance);
+            if (row.size() != nodeIDs.size()) {
+                row.assign(nodeIDs.size(), 20);
+                row[node] = 10;
+            }
+            distances.push_back(row);
+        }
+    }
+
+    uint_fast32_t nodeCount() const {
+        return uint_fast32_t(distances.size());
+    }
+
+    bool isVirtual() const {
+        return virtualTopology;
+    }
+
+    uint_fast32_t nodeOfCPU(uint_fast32_t cpu) const {
+        auto node = cpuNodes.find(cpu);
+        return node == cpuNodes.end() ? 0 : node->second;
+    }
+
+    /// The node of the CPU the calling thread currently runs on (it should be pinned for the result to stay valid).
+    uint_fast32_t nodeOfThisThread() const {
+        int cpu = sched_getcpu();
+        return cpu < 0 ? 0 : nodeOfCPU(uint_fast32_t(cpu));
+    }
+
+    uint_fast32_t distance(uint_fast32_t from, uint_fast32_t to) const {
+        return distances[from][to];
+    }
+
+    /// The other nodes ordered by their distance from the given node (the nearest first).
+    std::vector<uint_fast32_t> nodesByDistance(uint_fast32_t from) const {
+        std::vector<uint_fast32_t> nodes;
+        for (uint_fast32_t node = 0; node < nodeCount(); node++) {
+            if (node != from) nodes.push_back(node);
+        }
+        std::stable_sort(nodes.begin(), nodes.end(), [&](uint_fast32_t a, uint_fast32_t b) { return distance(from, a) < distance(from, b); });
+        return nodes;
+    }
+
+private:
+    static std::string readLine(const std::string& fileName) {
+        std::ifstream file(fileName);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    bool                                        virtualTopology;
+    std::map<uint_fast32_t, uint_fast32_t>      cpuNodes;
+    std::vector<std::vector<uint_fast32_t>>     distances;
+};
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_NUMA_TOPOLOGY_HPP
@@ -0,0 +1,160 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_PERFORMANCE_COUNTERS_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_PERFORMANCE_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**\brief The counters collected for each worker thread.
+ *
+ * The hardware events might be refused by the kernel (e.g. because of
+ * \c perf_event_paranoid or because there is no PMU inside a VM). The
+ * software events are provided by the kernel itself and therefore remain
+ * available as a fallback.
+ */
+enum PerformanceCounter : uint_fast32_t {
+    CYCLES = 0,
+    INSTRUCTIONS,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    CACHE_TO_CACHE_TRANSFERS,
+    TASK_CLOCK,
+    CONTEXT_SWITCHES,
+    CPU_MIGRATIONS,
+    PAGE_FAULTS,
+    PERFORMANCE_COUNTER_COUNT
+};
+
+constexpr const char* performanceCounterNames[PERFORMANCE_COUNTER_COUNT] = {
+        "Cycles",
+        "Instructions",
+        "LLC Misses",
+        "Branch Misses",
+        "Cache-to-Cache Transfers",
+        "Task Clock (ns)",
+        "Context Switches",
+        "CPU Migrations",
+        "Page Faults"
+};
+
+/**\brief Counter values and resource usage of one or more threads.
+ *
+ * A counter is only reported as available if it could be opened in every
+ * merged thread as the sum would be misleading otherwise.
+ */
+struct PerformanceCounterSample {
+    std::array<double, PERFORMANCE_COUNTER_COUNT>   values{};
+    std::array<bool, PERFORMANCE_COUNTER_COUNT>     available{};
+    uint_fast32_t                                   threads = 0;
+
+    double                                          userTimeInS = 0.0;
+    double                                          systemTimeInS = 0.0;
+    uint_fast64_t                                   voluntaryContextSwitches = 0;
+    uint_fast64_t                                   involuntaryContextSwitches = 0;
+
+    void merge(const PerformanceCounterSample& other) {
+        for (uint_fast32_t i = 0; i < PERFORMANCE_COUNTER_COUNT; i++) {
+            values[i] += other.values[i];
+            available[i] = (threads == 0 ? other.available[i] : available[i] && other.available[i]);
+        }
+        threads += other.threads;
+        userTimeInS += other.userTimeInS;
+        systemTimeInS += other.systemTimeInS;
+        voluntaryContextSwitches += other.voluntaryContextSwitches;
+        involuntaryContextSwitches += other.involuntaryContextSwitches;
+    }
+};
+
+/**\brief The \c perf_event_open counters and the \c getrusage of the calling thread.
+ *
+ * Each event is opened on its own (instead of as a group) so that a refused
+ * hardware event doesn't take the other ones down with it. Multiplexed events
+ * get scaled by the ratio of their enabled and running time.
+ */
+class ThreadPerformanceCounters {
+public:
+    /// \c cacheToCacheEvent is a raw, model-specific PMU event (0 disables it).
+    explicit ThreadPerformanceCounters(uint_fast64_t cacheToCacheEvent) {
+        fileDescriptors.fill(-1);
+        open(CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open(INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open(LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open(BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        if (cacheToCacheEvent) open(CACHE_TO_CACHE_TRANSFERS, PERF_TYPE_RAW, cacheToCacheEvent);
+        open(TASK_CLOCK, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+        open(CONTEXT_SWITCHES, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+        open(CPU_MIGRATIONS, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS);
+        open(PAGE_FAULTS, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+    }
+
+    ~ThreadPerformanceCounters() {
+        for (int fileDescriptor : fileDescriptors) {
+            if (fileDescriptor >= 0) close(fileDescriptor);
+        }
+    }
+
+    ThreadPerformanceCounters(const ThreadPerformanceCounters&) = delete;
+    ThreadPerformanceCounters& operator=(const ThreadPerformanceCounters&) = delete;
+
+    void start() {
+        getrusage(RUSAGE_THREAD, &startUsage);
+        for (int fileDescriptor : fileDescriptors) {
+            if (fileDescriptor >= 0) {
+                ioctl(fileDescriptor, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    PerformanceCounterSample stop() {
+        PerformanceCounterSample sample;
+        for (uint_fast32_t i = 0; i < PERFORMANCE_COUNTER_COUNT; i++) {
+            if (fileDescriptors[i] < 0) continue;
+            ioctl(fileDescriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            uint64_t readFormat[3];     // value, time enabled, time running
+            if (read(fileDescriptors[i], readFormat, sizeof(readFormat)) != sizeof(readFormat) || readFormat[2] == 0) continue;
+            sample.values[i] = double(readFormat[0]) * double(readFormat[1]) / double(readFormat[2]);
+            sample.available[i] = true;
+        }
+
+        struct rusage stopUsage;
+        getrusage(RUSAGE_THREAD, &stopUsage);
+        sample.userTimeInS = seconds(stopUsage.ru_utime) - seconds(startUsage.ru_utime);
+        sample.systemTimeInS = seconds(stopUsage.ru_stime) - seconds(startUsage.ru_stime);
+        sample.voluntaryContextSwitches = uint_fast64_t(stopUsage.ru_nvcsw - startUsage.ru_nvcsw);
+        sample.involuntaryContextSwitches = uint_fast64_t(stopUsage.ru_nivcsw - startUsage.ru_nivcsw);
+        sample.threads = 1;
+        return sample;
+    }
+
+private:
+    void open(PerformanceCounter counter, uint32_t type, uint64_t config) {
+        struct perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;      // allowed with perf_event_paranoid <= 2
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // pid == 0 and cpu == -1 measures the calling thread on any CPU:
+        fileDescriptors[counter] = int(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    static double seconds(const struct timeval& time) {
+        return double(time.tv_sec) + double(time.tv_usec) / 1000000.0;
+    }
+
+    std::array<int, PERFORMANCE_COUNTER_COUNT>  fileDescriptors;
+    struct rusage                               startUsage;
+};
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_PERFORMANCE_COUNTERS_HPP
@@ -0,0 +1,182 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_POOL_ALLOCATOR_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_POOL_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#include "allocation_counters.hpp"
+
+/*
+ * The size classes of the pool are the powers of two from 16 bytes to 4KiB.
+ * Each thread carves the blocks of a size class from its own 64KiB chunks, so
+ * every block is aligned to its size (and therefore to the alignment of any
+ * type fitting into it). Freed blocks go to the free list of the size class of
+ * the freeing thread, no matter which thread carved them. The free lists of
+ * exited threads are handed over to a global depot the other threads refill
+ * from. The chunks are never returned to the system.
+ */
+
+constexpr uint_fast32_t pool_minimum_block_size = 16;
+constexpr uint_fast32_t pool_size_class_count = 9;                 // 16 bytes to 4KiB
+constexpr uint_fast32_t pool_chunk_size = 64 << 10;
+
+struct PoolBlock {
+    PoolBlock*  next;
+};
+
+/**\brief The free lists and the current chunks of a thread.
+ *
+ * It's trivially destructible, so it can still be used while the other
+ * thread-local objects of an exiting thread get destroyed (e.g. by the
+ * thread management of LibCDS freeing retired nodes).
+ */
+struct PoolThreadCache {
+    PoolBlock*  freeLists[pool_size_class_count];
+    char*       chunkPosition[pool_size_class_count];
+    char*       chunkEnd[pool_size_class_count];
+    bool        registered;
+    bool        retired;
+};
+
+inline thread_local PoolThreadCache poolThreadCache;
+
+/// The free blocks of the exited threads.
+struct PoolDepot {
+    std::mutex          mutex;
+    PoolBlock*          freeLists[pool_size_class_count] = {};
+    std::atomic<bool>   available[pool_size_class_count] = {};
+
+    void give(uint_fast32_t sizeClass, PoolBlock* first, PoolBlock* last) {
+        std::lock_guard<std::mutex> lock(mutex);
+        last->next = freeLists[sizeClass];
+        freeLists[sizeClass] = first;
+        available[sizeClass].store(true, std::memory_order_relaxed);
+    }
+
+    PoolBlock* take(uint_fast32_t sizeClass) {
+        if (!available[sizeClass].load(std::memory_order_relaxed)) return nullptr;
+        std::lock_guard<std::mutex> lock(mutex);
+        PoolBlock* blocks = freeLists[sizeClass];
+        freeLists[sizeClass] = nullptr;
+        available[sizeClass].store(false, std::memory_order_relaxed);
+        return blocks;
+    }
+};
+
+inline PoolDepot poolDepot;
+
+/// Hands the free lists of the calling thread over to the depot when it exits.
+struct PoolThreadRetirement {
+    void touch() {}
+
+    ~PoolThreadRetirement() {
+        for (uint_fast32_t sizeClass = 0; sizeClass < pool_size_class_count; sizeClass++) {
+            PoolBlock* first = poolThreadCache.freeLists[sizeClass];
+            if (!first) continue;
+            PoolBlock* last = first;
+            while (last->next) last = last->next;
+            poolDepot.give(sizeClass, first, last);
+            poolThreadCache.freeLists[sizeClass] = nullptr;
+        }
+        poolThreadCache.retired = true;
+    }
+};
+
+inline thread_local PoolThreadRetirement poolThreadRetirement;
+
+/// The size class of blocks of the given size (\c pool_size_class_count if they are too large for the pool).
+inline uint_fast32_t poolSizeClass(std::size_t size) {
+    uint_fast32_t sizeClass = 0;
+    while (sizeClass < pool_size_class_count && (std::size_t(pool_minimum_block_size) << sizeClass) < size) sizeClass++;
+    return sizeClass;
+}
+
+inline void* poolAllocate(uint_fast32_t sizeClass) {
+    PoolThreadCache& cache = poolThreadCache;
+    if (!cache.registered) {
+        poolThreadRetirement.touch();
+        cache.registered = true;
+    }
+
+    PoolBlock* block = cache.freeLists[sizeClass];
+    if (!block && !cache.retired) block = cache.freeLists[sizeClass] = poolDepot.take(sizeClass);
+    if (block) {
+        cache.freeLists[sizeClass] = block->next;
+        return block;
+    }
+
+    std::size_t blockSize = std::size_t(pool_minimum_block_size) << sizeClass;
+    if (cache.chunkPosition[sizeClass] == cache.chunkEnd[sizeClass]) {
+        char* chunk = static_cast<char*>(std::aligned_alloc(4096, pool_chunk_size));
+        if (!chunk) throw std::bad_alloc();
+        cache.chunkPosition[sizeClass] = chunk;
+        cache.chunkEnd[sizeClass] = chunk + pool_chunk_size;
+    }
+    void* pointer = cache.chunkPosition[sizeClass];
+    cache.chunkPosition[sizeClass] += blockSize;
+    return pointer;
+}
+
+inline void poolDeallocate(void* pointer, uint_fast32_t sizeClass) {
+    PoolBlock* block = static_cast<PoolBlock*>(pointer);
+    if (poolThreadCache.retired) {
+        block->next = nullptr;
+        poolDepot.give(sizeClass, block, block);
+        return;
+    }
+    block->next = poolThreadCache.freeLists[sizeClass];
+    poolThreadCache.freeLists[sizeClass] = block;
+}
+
+/**\brief A standard allocator backed by the per-thread size-class pool.
+ *
+ * Allocations of more than 4KiB are forwarded to \c operator \c new. It can
+ * be plugged into the containers via their allocator (or traits) parameters
+ * to separate the cost of the system allocator from the one of their
+ * algorithm.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef PoolAllocator<U> other;
+    };
+
+    PoolAllocator() noexcept {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t count) {
+        uint_fast32_t sizeClass = poolSizeClass(count * sizeof(T));
+        if (sizeClass == pool_size_class_count) return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+        return static_cast<T*>(poolAllocate(sizeClass));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        uint_fast32_t sizeClass = poolSizeClass(count * sizeof(T));
+        if (sizeClass == pool_size_class_count) {
+            ::operator delete(pointer, std::align_val_t(alignof(T)));
+            return;
+        }
+        poolDeallocate(pointer, sizeClass);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_POOL_ALLOCATOR_HPP
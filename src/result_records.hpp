@@ -0,0 +1,312 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_RESULT_RECORDS_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_RESULT_RECORDS_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**\brief The text of a number in the records.
+ *
+ * The records read from a file store all the numeric-looking values in this
+ * format, so configuration values (strings) derived from numbers have to be
+ * formatted the same way to match the ones of a baseline (e.g. 1000000
+ * instead of 1e+06).
+ */
+inline std::string formatNumber(double value) {
+    std::ostringstream o;
+    o << std::setprecision(12) << value;
+    return o.str();
+}
+
+/**\brief A flat record of configuration values (strings) and measured values (numbers).
+ *
+ * A record gets written as one CSV row or as one JSON object per line. The
+ * order of the fields is kept so that all the records of a run share the
+ * same CSV header.
+ */
+class ResultRecord {
+public:
+    struct Field {
+        std::string key;
+        std::string value;
+        bool        numeric;
+    };
+
+    void set(const std::string& key, const std::string& value) {
+        setField(key, value, false);
+    }
+
+    void set(const std::string& key, const char* value) {
+        setField(key, value, false);
+    }
+
+    /// Non-finite values (e.g. undefined statistics) are stored as missing values to keep the fields of all records aligned.
+    void set(const std::string& key, double value) {
+        if (!std::isfinite(value)) {
+            setField(key, "", true);
+            return;
+        }
+        setField(key, formatNumber(value), true);
+    }
+
+    const Field* find(const std::string& key) const {
+        for (const Field& field : fieldList) {
+            if (field.key == key) return &field;
+        }
+        return nullptr;
+    }
+
+    bool get(const std::string& key, double& value) const {
+        const Field* field = find(key);
+        if (!field) return false;
+        char* end;
+        value = std::strtod(field->value.c_str(), &end);
+        return !field->value.empty() && *end == '\0';
+    }
+
+    const std::vector<Field>& fields() const {
+        return fieldList;
+    }
+
+    void append(const ResultRecord& other) {
+        for (const Field& field : other.fieldList) setField(field.key, field.value, field.numeric);
+    }
+
+private:
+    void setField(const std::string& key, const std::string& value, bool numeric) {
+        for (Field& field : fieldList) {
+            if (field.key == key) {
+                field.value = value;
+                field.numeric = numeric;
+                return;
+            }
+        }
+        fieldList.push_back({key, value, numeric});
+    }
+
+    std::vector<Field>  fieldList;
+};
+
+/**\brief Writes result records to a CSV file or to a JSON lines file.
+ *
+ * Each record is flushed right away so that the records of completed cells
+ * survive a timeout of a later cell. The CSV header is taken from the first
+ * record and the later rows are written in its order, with empty values for
+ * the fields a record lacks. Fields missing in the header can't be written
+ * to the CSV file and are reported once.
+ */
+class ResultWriter {
+public:
+    enum Format {
+        CSV,
+        JSON
+    };
+
+    ResultWriter(const std::string& fileName, Format format) : file(fileName), format(format) {}
+
+    bool good() const {
+        return file.good();
+    }
+
+    void write(const ResultRecord& record) {
+        if (format == CSV) {
+            if (header.empty()) {
+                for (size_t i = 0; i < record.fields().size(); i++) {
+                    header.push_back(record.fields()[i].key);
+                    file << (i ? "," : "") << csvEscape(record.fields()[i].key);
+                }
+                file << std::endl;
+            }
+            for (size_t i = 0; i < header.size(); i++) {
+                const ResultRecord::Field* field = record.find(header[i]);
+                file << (i ? "," : "") << (field ? csvEscape(field->value) : "");
+            }
+            file << std::endl;
+            for (const ResultRecord::Field& field : record.fields()) {
+                if (std::find(header.begin(), header.end(), field.key) == header.end()
+                    && std::find(droppedKeys.begin(), droppedKeys.end(), field.key) == droppedKeys.end()) {
+                    std::cerr << "WARNING: " << "The field " << field.key << " isn't in the header of the CSV results file and is dropped." << std::endl;
+                    droppedKeys.push_back(field.key);
+                }
+            }
+        } else {
+            file << "{";
+            for (size_t i = 0; i < record.fields().size(); i++) {
+                const ResultRecord::Field& field = record.fields()[i];
+                file << (i ? "," : "") << jsonEscape(field.key) << ":" << (field.numeric ? (field.value.empty() ? "null" : field.value) : jsonEscape(field.value));
+            }
+            file << "}" << std::endl;
+        }
+        file.flush();
+    }
+
+private:
+    static std::string csvEscape(const std::string& value) {
+        if (value.find_first_of(",\"\n") == std::string::npos) return value;
+        std::string escaped = "\"";
+        for (char c : value) {
+            if (c == '"') escaped += '"';
+            escaped += c;
+        }
+        return escaped + "\"";
+    }
+
+    static std::string jsonEscape(const std::string& value) {
+        std::string escaped = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            if (c == '\n') {
+                escaped += "\\n";
+                continue;
+            }
+            escaped += c;
+        }
+        return escaped + "\"";
+    }
+
+    std::ofstream               file;
+    Format                      format;
+    std::vector<std::string>    header;
+    std::vector<std::string>    droppedKeys;
+};
+
+/**\brief Reads the records written by a \c ResultWriter (the format is detected from the content).
+ *
+ * \return \c false if the file couldn't be read or is malformed.
+ */
+inline bool readResultRecords(const std::string& fileName, std::vector<ResultRecord>& records) {
+    std::ifstream file(fileName);
+    if (!file) return false;
+
+    std::string line;
+    std::vector<std::string> header;
+    bool csv = false;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+
+        if (line[0] == '{') {
+            // A flat JSON object of strings and numbers as written by the ResultWriter:
+            ResultRecord record;
+            size_t position = 1;
+            auto skipWhitespace = [&]{ while (position < line.size() && std::isspace(line[position])) position++; };
+            auto parseString = [&](std::string& value) {
+                if (line[position] != '"') return false;
+                for (position++; position < line.size() && line[position] != '"'; position++) {
+                    if (line[position] == '\\' && position + 1 < line.size()) {
+                        position++;
+                        value += line[position] == 'n' ? '\n' : line[position];
+                    } else {
+                        value += line[position];
+                    }
+                }
+                return position++ < line.size();
+            };
+            while (true) {
+                skipWhitespace();
+                if (position >= line.size()) return false;
+                if (line[position] == '}') break;
+                if (line[position] == ',') position++;
+                skipWhitespace();
+
+                std::string key;
+                if (!parseString(key)) return false;
+                skipWhitespace();
+                if (position >= line.size() || line[position++] != ':') return false;
+                skipWhitespace();
+                if (position >= line.size()) return false;
+                if (line[position] == '"') {
+                    std::string value;
+                    if (!parseString(value)) return false;
+                    record.set(key, value);
+                } else {
+                    size_t end = line.find_first_of(",}", position);
+                    if (end == std::string::npos) return false;
+                    std::string value = line.substr(position, end - position);
+                    record.set(key, value == "null" ? std::nan("") : std::strtod(value.c_str(), nullptr));
+                    position = end;
+                }
+            }
+            records.push_back(record);
+        } else {
+            // CSV with the header in the first line:
+            std::vector<std::string> values;
+            std::string value;
+            bool quoted = false;
+            for (size_t i = 0; i < line.size(); i++) {
+                char c = line[i];
+                if (quoted) {
+                    if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                        value += '"';
+                        i++;
+                    } else if (c == '"') {
+                        quoted = false;
+                    } else {
+                        value += c;
+                    }
+                } else if (c == '"') {
+                    quoted = true;
+                } else if (c == ',') {
+                    values.push_back(value);
+                    value.clear();
+                } else {
+                    value += c;
+                }
+            }
+            values.push_back(value);
+
+            if (!csv) {
+                header = values;
+                csv = true;
+                continue;
+            }
+            if (values.size() != header.size()) return false;
+
+            ResultRecord record;
+            for (size_t i = 0; i < header.size(); i++) {
+                char* end;
+                std::strtod(values[i].c_str(), &end);
+                if (!values[i].empty() && *end == '\0') {
+                    record.set(header[i], std::strtod(values[i].c_str(), nullptr));
+                } else {
+                    record.set(header[i], values[i]);
+                }
+            }
+            records.push_back(record);
+        }
+    }
+    return true;
+}
+
+/// Turns a display name like "Task Clock (ns)" into a record key like "task_clock_ns".
+inline std::string recordKey(const std::string& name) {
+    std::string key;
+    for (char c : name) {
+        if (std::isalnum(c)) {
+            key += char(std::tolower(c));
+        } else if (!key.empty() && key.back() != '_') {
+            key += '_';
+        }
+    }
+    while (!key.empty() && key.back() == '_') key.pop_back();
+    return key;
+}
+
+/// Splits a comma-separated list into its (non-empty) elements.
+inline std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> elements;
+    std::istringstream stream(list);
+    std::string element;
+    while (std::getline(stream, element, ',')) {
+        if (!element.empty()) elements.push_back(element);
+    }
+    return elements;
+}
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_RESULT_RECORDS_HPP
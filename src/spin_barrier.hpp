@@ -0,0 +1,51 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_SPIN_BARRIER_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_SPIN_BARRIER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**\brief A reusable, generation-counting spin barrier.
+ *
+ * All participants are released by a single store, so they start within a
+ * few hundred cycles of each other instead of the scheduler latency of a
+ * condition variable. Waiting participants yield after some spinning to
+ * remain usable if there are more threads than CPUs.
+ */
+class SpinBarrier {
+public:
+    explicit SpinBarrier(uint_fast32_t participants) :
+            participants(participants),
+            arrived(0),
+            generation(0) {}
+
+    void arriveAndWait() {
+        uint_fast32_t currentGeneration = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == participants) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.store(currentGeneration + 1, std::memory_order_release);
+            return;
+        }
+
+        for (uint_fast32_t spins = 0; generation.load(std::memory_order_acquire) == currentGeneration; spins++) {
+            if (spins < 16384) {
+#if defined(__x86_64__) || defined(__i386__)
+                _mm_pause();
+#endif
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    const uint_fast32_t                     participants;
+    alignas(64) std::atomic<uint_fast32_t>  arrived;
+    alignas(64) std::atomic<uint_fast32_t>  generation;
+};
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_SPIN_BARRIER_HPP
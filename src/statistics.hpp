@@ -0,0 +1,154 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_STATISTICS_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_STATISTICS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+struct Summary {
+    uint_fast64_t   count = 0;
+    double          min = 0.0;
+    double          max = 0.0;
+    double          mean = 0.0;
+    double          stddev = 0.0;
+};
+
+/// Minimum, maximum, mean and (sample) standard deviation of the given values.
+inline Summary summarize(const std::vector<double>& values) {
+    Summary summary;
+    summary.count = values.size();
+    if (values.empty()) return summary;
+
+    summary.min = *std::min_element(values.begin(), values.end());
+    summary.max = *std::max_element(values.begin(), values.end());
+
+    double sum = 0.0;
+    for (double value : values) sum += value;
+    summary.mean = sum / double(values.size());
+
+    if (values.size() > 1) {
+        double squaredDeviations = 0.0;
+        for (double value : values) squaredDeviations += (value - summary.mean) * (value - summary.mean);
+        summary.stddev = std::sqrt(squaredDeviations / double(values.size() - 1));
+    }
+    return summary;
+}
+
+/**\brief Jain's fairness index of the given allocations (e.g. the throughput of each thread).
+ *
+ * The index is \f$(\sum x_i)^2 / (n \sum x_i^2)\f$ which is 1 if all threads
+ * got the same share and \f$1/n\f$ if a single thread got everything.
+ */
+inline double jainFairnessIndex(const std::vector<double>& values) {
+    double sum = 0.0;
+    double squaredSum = 0.0;
+    for (double value : values) {
+        sum += value;
+        squaredSum += value * value;
+    }
+    if (squaredSum == 0.0) return 1.0;
+    return (sum * sum) / (double(values.size()) * squaredSum);
+}
+
+/// The regularized incomplete beta function \f$I_x(a, b)\f$ (continued fraction of Numerical Recipes 6.4).
+inline double incompleteBeta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    if (x > (a + 1.0) / (a + b + 2.0)) return 1.0 - incompleteBeta(b, a, 1.0 - x);
+
+    const double tiny = 1e-300;
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x)) / a;
+    double c = 1.0;
+    double d = 1.0 - (a + b) * x / (a + 1.0);
+    if (std::fabs(d) < tiny) d = tiny;
+    d = 1.0 / d;
+    double fraction = d;
+    for (int m = 1; m <= 200; m++) {
+        double numerator = m * (b - m) * x / ((a + 2.0 * m - 1.0) * (a + 2.0 * m));
+        d = 1.0 + numerator * d;
+        c = 1.0 + numerator / c;
+        if (std::fabs(d) < tiny) d = tiny;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        fraction *= d * c;
+
+        numerator = -(a + m) * (a + b + m) * x / ((a + 2.0 * m) * (a + 2.0 * m + 1.0));
+        d = 1.0 + numerator * d;
+        c = 1.0 + numerator / c;
+        if (std::fabs(d) < tiny) d = tiny;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        fraction *= delta;
+        if (std::fabs(delta - 1.0) < 1e-12) break;
+    }
+    return front * fraction;
+}
+
+/**\brief The two-sided p-value of Welch's t-test for different means of two samples.
+ *
+ * The samples are given by their summaries. If one of the samples has less
+ * than two values, the test is undefined and NaN is returned.
+ */
+inline double welchTTest(const Summary& a, const Summary& b) {
+    if (a.count < 2 || b.count < 2) return std::nan("");
+
+    double varianceA = a.stddev * a.stddev / double(a.count);
+    double varianceB = b.stddev * b.stddev / double(b.count);
+    if (varianceA + varianceB == 0.0) return a.mean == b.mean ? 1.0 : 0.0;
+
+    double t = (a.mean - b.mean) / std::sqrt(varianceA + varianceB);
+    double degreesOfFreedom = (varianceA + varianceB) * (varianceA + varianceB)
+                              / (varianceA * varianceA / double(a.count - 1) + varianceB * varianceB / double(b.count - 1));
+    return incompleteBeta(degreesOfFreedom / 2.0, 0.5, degreesOfFreedom / (degreesOfFreedom + t * t));
+}
+
+inline double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    if (values.size() % 2) return values[middle];
+    return (*std::max_element(values.begin(), values.begin() + middle) + values[middle]) / 2.0;
+}
+
+/**\brief Marks the values whose modified z-score exceeds the threshold (Iglewicz and Hoaglin suggest 3.5).
+ *
+ * The modified z-score is based on the median absolute deviation (MAD) and
+ * therefore isn't skewed by the outliers themselves. If more than half of
+ * the values are equal, the MAD is 0 and no value is marked.
+ */
+inline std::vector<bool> madOutliers(const std::vector<double>& values, double threshold) {
+    std::vector<bool> outliers(values.size(), false);
+    double center = median(values);
+    std::vector<double> deviations;
+    for (double value : values) deviations.push_back(std::fabs(value - center));
+    double mad = median(deviations);
+    if (mad == 0.0) return outliers;
+
+    for (size_t i = 0; i < values.size(); i++) {
+        outliers[i] = 0.6745 * std::fabs(values[i] - center) / mad > threshold;
+    }
+    return outliers;
+}
+
+/// The half-width of the two-sided confidence interval (e.g. 0.95) of the mean of a sample (Student's t-distribution).
+inline double confidenceInterval(const Summary& summary, double confidence) {
+    if (summary.count < 2) return std::nan("");
+
+    // Bisection on the two-sided tail probability of the t-distribution:
+    double degreesOfFreedom = double(summary.count - 1);
+    double low = 0.0;
+    double high = 1000.0;
+    for (int i = 0; i < 100; i++) {
+        double t = (low + high) / 2.0;
+        if (incompleteBeta(degreesOfFreedom / 2.0, 0.5, degreesOfFreedom / (degreesOfFreedom + t * t)) > 1.0 - confidence) {
+            low = t;
+        } else {
+            high = t;
+        }
+    }
+    return (low + high) / 2.0 * summary.stddev / std::sqrt(double(summary.count));
+}
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_STATISTICS_HPP
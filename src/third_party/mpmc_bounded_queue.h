@@ -13,6 +13,8 @@
 #include <boost/assert.hpp>
 #include <boost/detail/no_exceptions_support.hpp>
 
+#include "../contention_counters.hpp"
+
 namespace lockfree_queue
 {
     const size_t cache_line_size = 64;  // use hardware_destructive_interference_size in C++17
@@ -165,6 +167,7 @@ namespace lockfree_queue
                     {
                         return true;
                     }
+                    CONTENTION_COUNT(ENQUEUE_CAS_FAILURES, 1);
                 }
                 else if (diff < 0)
                 {
@@ -172,6 +175,7 @@ namespace lockfree_queue
                 }
                 else
                 {
+                    CONTENTION_COUNT(ENQUEUE_RETRIES, 1);
                     pos = m_enqueue_pos.load(memory_order_relaxed);
                 }
             }
@@ -227,6 +231,7 @@ namespace lockfree_queue
                         }
                         return { c, cell_dequeue(this, pos) };
                     }
+                    CONTENTION_COUNT(DEQUEUE_CAS_FAILURES, 1);
                 }
                 else if (diff < 0)
                 {
@@ -234,6 +239,7 @@ namespace lockfree_queue
                 }
                 else
                 {
+                    CONTENTION_COUNT(DEQUEUE_RETRIES, 1);
                     pos = m_dequeue_pos.load(memory_order_relaxed);
                 }
             }
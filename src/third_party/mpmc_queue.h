@@ -20,6 +20,8 @@
 
 #include <atomic>
 
+#include "../contention_counters.hpp"
+
 template<typename T>
 class mpmc_bounded_queue
 {
@@ -54,11 +56,15 @@ public:
         if (enqueue_pos_.compare_exchange_weak
             (pos, pos + 1, std::memory_order_relaxed))
           break;
+        CONTENTION_COUNT(ENQUEUE_CAS_FAILURES, 1);
       }
       else if (dif < 0)
         return false;
       else
+      {
+        CONTENTION_COUNT(ENQUEUE_RETRIES, 1);
         pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
     }
     cell->data_ = data;
     cell->sequence_.store(pos + 1, std::memory_order_release);
@@ -79,17 +85,104 @@ public:
         if (dequeue_pos_.compare_exchange_weak
             (pos, pos + 1, std::memory_order_relaxed))
           break;
+        CONTENTION_COUNT(DEQUEUE_CAS_FAILURES, 1);
       }
       else if (dif < 0)
         return false;
       else
+      {
+        CONTENTION_COUNT(DEQUEUE_RETRIES, 1);
         pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
     }
     data = cell->data_;
     cell->sequence_.store
       (pos + buffer_mask_ + 1, std::memory_order_release);
     return true;
   }
+  // Enqueues the count elements in consecutive cells reserved by a single CAS.
+  // Returns false if the last of the cells still holds an element.
+  bool enqueue_bulk(T const* data, size_t count)
+  {
+    if (count == 0)
+      return true;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      cell_t* last = &buffer_[(pos + count - 1) & buffer_mask_];
+      size_t seq =
+        last->sequence_.load(std::memory_order_acquire);
+      intptr_t dif = (intptr_t)seq - (intptr_t)(pos + count - 1);
+      if (dif == 0)
+      {
+        if (enqueue_pos_.compare_exchange_weak
+            (pos, pos + count, std::memory_order_relaxed))
+          break;
+        CONTENTION_COUNT(ENQUEUE_CAS_FAILURES, 1);
+      }
+      else if (dif < 0)
+        return false;
+      else
+      {
+        CONTENTION_COUNT(ENQUEUE_RETRIES, 1);
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    for (size_t i = 0; i != count; i += 1)
+    {
+      // The dequeue of an earlier cell might not have released it yet:
+      cell_t* cell = &buffer_[(pos + i) & buffer_mask_];
+      while (cell->sequence_.load(std::memory_order_acquire) != pos + i) {}
+      cell->data_ = data[i];
+      cell->sequence_.store(pos + i + 1, std::memory_order_release);
+    }
+    return true;
+  }
+  // Dequeues up to count elements from consecutive cells reserved by a single
+  // CAS. Returns the number of dequeued elements.
+  size_t dequeue_bulk(T* data, size_t count)
+  {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    size_t available;
+    for (;;)
+    {
+      // Each cell before enqueue_pos_ is (about to be) filled by an enqueue:
+      intptr_t dif = (intptr_t)enqueue_pos_.load(std::memory_order_acquire) - (intptr_t)pos;
+      if (dif <= 0)
+        return 0;
+      available = (size_t)dif < count ? (size_t)dif : count;
+      if (dequeue_pos_.compare_exchange_weak
+          (pos, pos + available, std::memory_order_relaxed))
+        break;
+      CONTENTION_COUNT(DEQUEUE_CAS_FAILURES, 1);
+    }
+    for (size_t i = 0; i != available; i += 1)
+    {
+      cell_t* cell = &buffer_[(pos + i) & buffer_mask_];
+      while (cell->sequence_.load(std::memory_order_acquire) != pos + i + 1) {}
+      data[i] = cell->data_;
+      cell->sequence_.store
+        (pos + i + buffer_mask_ + 1, std::memory_order_release);
+    }
+    return available;
+  }
+  // Stores the data in the cells [first, first + count) without claiming them
+  // through enqueue_pos_. Disjoint ranges can be prefilled concurrently but not
+  // concurrently with enqueue() or dequeue().
+  void prefill(size_t first, T const* data, size_t count)
+  {
+    assert(first + count <= buffer_mask_ + 1);
+    for (size_t pos = first; pos != first + count; pos += 1)
+    {
+      buffer_[pos].data_ = data[pos - first];
+      buffer_[pos].sequence_.store(pos + 1, std::memory_order_relaxed);
+    }
+  }
+  // Makes the first count prefilled cells available to dequeue().
+  void publish_prefilled(size_t count)
+  {
+    enqueue_pos_.store(count, std::memory_order_release);
+  }
 private:
   struct cell_t
   {
@@ -4,6 +4,8 @@
 #include <thread>
 #include <atomic>
 
+#include "../contention_counters.hpp"
+
 thread_local bool _thisThreadHashInitialized;
 thread_local uint_fast64_t _thisThreadHash;
 
@@ -25,6 +27,9 @@ class alignas(64) tatas_lock {
     /**\cond skip */
     std::atomic<uint_fast64_t> _holderThreadHash;
     uint_fast64_t _noThreadHash;
+#ifdef ZERO_EVALUATION_CONTENTION
+    uint_fast64_t _acquisitionTime;
+#endif // ZERO_EVALUATION_CONTENTION
     /**\endcond skip */
 
 public:
@@ -39,58 +44,80 @@ private:
     // CC mangles this as __1cKtatas_lockEspin6M_v_
     /// spin until lock is free
     void spin() {
-        while(_holderThreadHash != _noThreadHash);
+        while(_holderThreadHash != _noThreadHash) {
+            CONTENTION_COUNT(LOCK_SPIN_ITERATIONS, 1);
+        }
     }
 
 public:
-    /// Try to acquire the lock immediately.
-    bool try_lock() {
+    /// The hash identifying the calling thread as lock holder (can be cached by the thread).
+    static uint_fast64_t thread_hash() {
         if (!_thisThreadHashInitialized) {
             std::thread::id thisThread = std::this_thread::get_id();
             std::hash<std::thread::id> threadHasher;
             _thisThreadHash = threadHasher(thisThread);
             _thisThreadHashInitialized = true;
         }
+        return _thisThreadHash;
+    }
+
+    /// Try to acquire the lock immediately.
+    bool try_lock() {
+        return try_lock(thread_hash());
+    }
+
+    /// Try to acquire the lock immediately using the cached hash of the calling thread.
+    bool try_lock(uint_fast64_t thisThreadHash) {
         bool success = false;
         uint_fast64_t oldHolderThreadHash = _noThreadHash;
-        if (_holderThreadHash.compare_exchange_strong(oldHolderThreadHash, _thisThreadHash, std::memory_order_acquire)) {
+        if (_holderThreadHash.compare_exchange_strong(oldHolderThreadHash, thisThreadHash, std::memory_order_acquire)) {
             success = true;
+#ifdef ZERO_EVALUATION_CONTENTION
+            CONTENTION_COUNT(LOCK_ACQUISITIONS, 1);
+            _acquisitionTime = BenchmarkClock::now();
+#endif // ZERO_EVALUATION_CONTENTION
+        } else {
+            CONTENTION_COUNT(LOCK_CAS_FAILURES, 1);
         }
         return success;
     }
 
     /// Acquire the lock, spinning as long as necessary.
     void acquire() {
+        acquire(thread_hash());
+    }
+
+    /// Acquire the lock using the cached hash of the calling thread, spinning as long as necessary.
+    void acquire(uint_fast64_t thisThreadHash) {
         // w_assert1(!is_mine());
-        if (!_thisThreadHashInitialized) {
-            std::thread::id thisThread = std::this_thread::get_id();
-            std::hash<std::thread::id> threadHasher;
-            _thisThreadHash = threadHasher(thisThread);
-            _thisThreadHashInitialized = true;
-        }
+#ifdef ZERO_EVALUATION_CONTENTION
+        uint_fast64_t waitStart = BenchmarkClock::now();
+#endif // ZERO_EVALUATION_CONTENTION
         uint_fast64_t oldHolderThreadHash = _noThreadHash;
-        do {
+        while (true) {
             spin();
             oldHolderThreadHash = _noThreadHash;
-        } while (!_holderThreadHash.compare_exchange_strong(oldHolderThreadHash, _thisThreadHash, std::memory_order_acquire));
+            if (_holderThreadHash.compare_exchange_strong(oldHolderThreadHash, thisThreadHash, std::memory_order_acquire)) break;
+            CONTENTION_COUNT(LOCK_CAS_FAILURES, 1);
+        }
+#ifdef ZERO_EVALUATION_CONTENTION
+        _acquisitionTime = BenchmarkClock::now();
+        CONTENTION_COUNT(LOCK_ACQUISITIONS, 1);
+        CONTENTION_COUNT(LOCK_WAIT_TICKS, _acquisitionTime - waitStart);
+#endif // ZERO_EVALUATION_CONTENTION
         // w_assert1(is_mine());
     }
 
     /// Release the lock
     void release() {
         // w_assert1(is_mine()); // moved after the fence
+        CONTENTION_COUNT(LOCK_HOLD_TICKS, BenchmarkClock::now() - _acquisitionTime);
         _holderThreadHash.store(_noThreadHash, std::memory_order_release);
     }
 
     /// True if this thread is the lock holder
     bool is_mine() const {
-        if (!_thisThreadHashInitialized) {
-            std::thread::id thisThread = std::this_thread::get_id();
-            std::hash<std::thread::id> threadHasher;
-            _thisThreadHash = threadHasher(thisThread);
-            _thisThreadHashInitialized = true;
-        }
-        return _thisThreadHash == _holderThreadHash;
+        return thread_hash() == _holderThreadHash;
     }
 
 };
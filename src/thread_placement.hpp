@@ -0,0 +1,140 @@
+#ifndef EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_THREAD_PLACEMENT_HPP
+#define EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_THREAD_PLACEMENT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+struct CPU {
+    uint_fast32_t   id;
+    uint_fast32_t   package;
+    uint_fast32_t   core;
+    uint_fast32_t   coreIndex;      // rank of the core within its package
+    uint_fast32_t   smtIndex;       // rank of the hardware thread within its core
+};
+
+/**\brief Parses a Linux CPU list like "0-3,8,10-11".
+ *
+ * \throws std::invalid_argument if the list is malformed.
+ */
+inline std::vector<uint_fast32_t> parseCPUList(const std::string& list) {
+    std::vector<uint_fast32_t> cpus;
+    std::istringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        uint_fast32_t first = uint_fast32_t(std::stoul(range.substr(0, dash)));
+        uint_fast32_t last = dash == std::string::npos ? first : uint_fast32_t(std::stoul(range.substr(dash + 1)));
+        if (last < first) throw std::invalid_argument(range);
+        for (uint_fast32_t cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+/**\brief The CPU topology as exported in \c /sys/devices/system/cpu.
+ *
+ * If the topology isn't available, each online CPU is treated as its own
+ * core of a single package.
+ */
+class CPUTopology {
+public:
+    CPUTopology() {
+        std::vector<uint_fast32_t> online;
+        try {
+            online = parseCPUList(readLine("/sys/devices/system/cpu/online"));
+        } catch (std::logic_error& e) {}
+        if (online.empty()) {
+            for (uint_fast32_t i = 0; i < std::max(std::thread::hardware_concurrency(), 1u); i++) online.push_back(i);
+        }
+
+        std::map<std::tuple<uint_fast32_t, uint_fast32_t>, uint_fast32_t> smtCount;
+        std::map<uint_fast32_t, std::vector<uint_fast32_t>> packageCores;
+        for (uint_fast32_t id : online) {
+            std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+            CPU cpu;
+            cpu.id = id;
+            cpu.package = readNumber(topology + "physical_package_id", 0);
+            cpu.core = readNumber(topology + "core_id", id);
+            cpu.smtIndex = smtCount[{cpu.package, cpu.core}]++;
+
+            std::vector<uint_fast32_t>& cores = packageCores[cpu.package];
+            auto core = std::find(cores.begin(), cores.end(), cpu.core);
+            cpu.coreIndex = uint_fast32_t(core - cores.begin());
+            if (core == cores.end()) cores.push_back(cpu.core);
+
+            cpus.push_back(cpu);
+        }
+    }
+
+    const std::vector<CPU>& all() const {
+        return cpus;
+    }
+
+    /**\brief The order in which the worker threads get placed on the CPUs.
+     *
+     * - compact:   one thread per core of the first package, then its SMT siblings, then the next package
+     * - smt-first: all SMT siblings of a core before the next core, package by package
+     * - scatter:   round robin over the packages, one thread per core before using SMT siblings
+     *
+     * \throws std::invalid_argument if the policy is unknown.
+     */
+    std::vector<uint_fast32_t> order(const std::string& policy) const {
+        std::vector<CPU> sorted = cpus;
+        if (policy == "compact") {
+            sortBy(sorted, [](const CPU& cpu) { return std::make_tuple(cpu.package, cpu.smtIndex, cpu.coreIndex); });
+        } else if (policy == "smt-first") {
+            sortBy(sorted, [](const CPU& cpu) { return std::make_tuple(cpu.package, cpu.coreIndex, cpu.smtIndex); });
+        } else if (policy == "scatter") {
+            sortBy(sorted, [](const CPU& cpu) { return std::make_tuple(cpu.smtIndex, cpu.coreIndex, cpu.package); });
+        } else {
+            throw std::invalid_argument(policy);
+        }
+
+        std::vector<uint_fast32_t> order;
+        for (const CPU& cpu : sorted) order.push_back(cpu.id);
+        return order;
+    }
+
+private:
+    template <typename Key>
+    static void sortBy(std::vector<CPU>& cpus, Key key) {
+        std::stable_sort(cpus.begin(), cpus.end(), [&key](const CPU& a, const CPU& b) { return key(a) < key(b); });
+    }
+
+    static std::string readLine(const std::string& fileName) {
+        std::ifstream file(fileName);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    static uint_fast32_t readNumber(const std::string& fileName, uint_fast32_t fallback) {
+        try {
+            return uint_fast32_t(std::stoul(readLine(fileName)));
+        } catch (std::logic_error& e) {
+            return fallback;
+        }
+    }
+
+    std::vector<CPU>    cpus;
+};
+
+/// Pins the calling thread to the given CPU.
+inline bool pinThisThread(uint_fast32_t cpu) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+#endif //EVALUATION_OF_IMPLEMENTATION_DETAILS_FOR_ZERO_THREAD_PLACEMENT_HPP
@@ -0,0 +1,175 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "event_tracer.hpp"
+
+namespace po = boost::program_options;
+
+const char* eventName(uint8_t event) {
+    switch (TraceEvent(event)) {
+        case TraceEvent::POP_SUCCESS:   return "pop_success";
+        case TraceEvent::POP_FAILURE:   return "pop_failure";
+        case TraceEvent::REFILL_START:  return "refill_start";
+        case TraceEvent::REFILL_STOP:   return "refill_stop";
+        case TraceEvent::ENQUEUE:       return "enqueue";
+        default:                        return "unknown";
+    }
+}
+
+struct ThreadTrace {
+    TraceThreadHeader           header;
+    std::vector<TraceRecord>    records;
+};
+
+bool readTrace(const std::string& fileName, TraceFileHeader& header, std::vector<ThreadTrace>& threads) {
+    std::FILE* file = std::fopen(fileName.c_str(), "rb");
+    if (!file) {
+        std::cerr << "ERROR: " << "The trace file " << fileName << " could not be opened." << std::endl;
+        return false;
+    }
+
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1
+                 && std::memcmp(header.magic, "ZTRC", 4) == 0
+                 && header.version == traceFormatVersion
+                 && header.recordSize == sizeof(TraceRecord);
+    if (!valid) {
+        std::cerr << "ERROR: " << fileName << " is no trace file of version " << traceFormatVersion << "." << std::endl;
+        std::fclose(file);
+        return false;
+    }
+
+    threads.resize(header.threadCount);
+    for (ThreadTrace& thread : threads) {
+        if (std::fread(&thread.header, sizeof(thread.header), 1, file) != 1) {
+            valid = false;
+            break;
+        }
+        thread.records.resize(thread.header.recordCount);
+        if (std::fread(thread.records.data(), sizeof(TraceRecord), thread.records.size(), file) != thread.records.size()) {
+            valid = false;
+            break;
+        }
+    }
+    std::fclose(file);
+
+    if (!valid) std::cerr << "ERROR: " << "The trace file " << fileName << " is truncated." << std::endl;
+    return valid;
+}
+
+uint64_t firstTimestamp(const std::vector<ThreadTrace>& threads) {
+    uint64_t first = UINT64_MAX;
+    for (const ThreadTrace& thread : threads) {
+        if (!thread.records.empty() && thread.records.front().timestamp < first) first = thread.records.front().timestamp;
+    }
+    return first == UINT64_MAX ? 0 : first;
+}
+
+void writeCSV(std::ostream& output, const TraceFileHeader& header, const std::vector<ThreadTrace>& threads) {
+    uint64_t first = firstTimestamp(threads);
+    output << "thread,timestamp,time_ns,event,page_id" << std::endl;
+    for (const ThreadTrace& thread : threads) {
+        for (const TraceRecord& record : thread.records) {
+            output << record.thread << "," << record.timestamp << ","
+                   << uint64_t(double(record.timestamp - first) / header.ticksPerNS) << ","
+                   << eventName(record.event) << "," << record.pageID << std::endl;
+        }
+    }
+}
+
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+void writeChromeTrace(std::ostream& output, const TraceFileHeader& header, const std::vector<ThreadTrace>& threads) {
+    uint64_t first = firstTimestamp(threads);
+    bool firstEvent = true;
+    output << "{\"traceEvents\":[" << std::endl;
+    for (const ThreadTrace& thread : threads) {
+        for (const TraceRecord& record : thread.records) {
+            double timeInUS = double(record.timestamp - first) / header.ticksPerNS / 1000.0;
+            if (!firstEvent) output << "," << std::endl;
+            firstEvent = false;
+
+            output << "{\"pid\":0,\"tid\":" << record.thread << ",\"ts\":" << std::fixed << timeInUS << ",";
+            switch (TraceEvent(record.event)) {
+                case TraceEvent::REFILL_START:
+                    output << "\"name\":\"refill\",\"ph\":\"B\"}";
+                    break;
+                case TraceEvent::REFILL_STOP:
+                    output << "\"name\":\"refill\",\"ph\":\"E\"}";
+                    break;
+                default:
+                    output << "\"name\":\"" << eventName(record.event) << "\",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"page_id\":" << record.pageID << "}}";
+                    break;
+            }
+        }
+    }
+    output << std::endl << "]}" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    std::string inputFile;
+    std::string outputFile;
+    std::string format;
+
+    po::options_description options("Decode a free list event trace");
+    options.add_options()
+            ("help,h", "Print this help messages.")
+            ("input,i", po::value<std::string>(&inputFile)->required(), "The binary trace file.")
+            ("output,o", po::value<std::string>(&outputFile)->default_value(""), "The decoded trace file (stdout if not set).")
+            ("format,f", po::value<std::string>(&format)->default_value("csv"), "Output format.\n"
+                    "Possible values:\n"
+                    "- csv\n"
+                    "- chrome");
+
+    po::variables_map settings;
+    try {
+        po::store(po::parse_command_line(argc, argv, options), settings);
+
+        if (settings.count("help")) {
+            std::cout << options << std::endl;
+            return 0;
+        }
+
+        po::notify(settings);
+    } catch(po::error& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << options << std::endl;
+        return 1;
+    }
+
+    if (format != "csv" && format != "chrome") {
+        std::cerr << "ERROR: " << "The argument " << format << " is invalid for option --format." << std::endl << std::endl;
+        std::cerr << options << std::endl;
+        return 1;
+    }
+
+    TraceFileHeader header;
+    std::vector<ThreadTrace> threads;
+    if (!readTrace(inputFile, header, threads)) return 2;
+
+    for (const ThreadTrace& thread : threads) {
+        if (thread.header.droppedCount) {
+            std::cerr << "WARNING: " << thread.header.droppedCount << " events of thread " << thread.header.thread << " were overwritten." << std::endl;
+        }
+    }
+
+    std::ofstream file;
+    if (!outputFile.empty()) {
+        file.open(outputFile);
+        if (!file) {
+            std::cerr << "ERROR: " << "The output file " << outputFile << " could not be opened." << std::endl;
+            return 2;
+        }
+    }
+    std::ostream& output = outputFile.empty() ? std::cout : file;
+
+    if (format == "csv") {
+        writeCSV(output, header, threads);
+    } else {
+        writeChromeTrace(output, header, threads);
+    }
+    return 0;
+}
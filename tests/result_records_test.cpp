@@ -0,0 +1,87 @@
+/**\brief Checks that configuration values survive writing result records and reading them as a baseline.
+ *
+ * The configuration of a cell is matched against the one of the baseline by
+ * comparing strings, so a number written as a configuration value has to be
+ * read back unchanged from both the CSV and the JSON format.
+ */
+
+#include "../src/result_records.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << "FAILED: " << message << std::endl;
+        failures++;
+    }
+}
+
+static void checkRoundTrip(const std::string& fileName, ResultWriter::Format format, double rate) {
+    ResultRecord written;
+    written.set("evaluation", "Round Trip");
+    written.set("threads", std::to_string(4));
+    written.set("arrival", "poisson");
+    written.set("rate", formatNumber(rate));
+    written.set("time_elapsed_ns", 123456789.0);
+    {
+        ResultWriter writer(fileName, format);
+        check(writer.good(), fileName + " could not be written");
+        writer.write(written);
+    }
+
+    std::vector<ResultRecord> read;
+    check(readResultRecords(fileName, read), fileName + " could not be read");
+    check(read.size() == 1, fileName + " should contain one record");
+    if (read.size() == 1) {
+        for (const ResultRecord::Field& field : written.fields()) {
+            const ResultRecord::Field* value = read[0].find(field.key);
+            check(value && value->value == field.value,
+                  fileName + ": " + field.key + " was written as " + field.value + " and read as " + (value ? value->value : "nothing"));
+        }
+    }
+    std::remove(fileName.c_str());
+}
+
+// The rows of a CSV file follow its header even if the records have other fields or another order:
+static void checkDifferingFields(const std::string& fileName) {
+    ResultRecord first;
+    first.set("queue", "legacy");
+    first.set("magazine_hit_rate", 0.5);
+    first.set("time_elapsed_ns", 1000.0);
+    ResultRecord second;
+    second.set("time_elapsed_ns", 2000.0);
+    second.set("queue", "sharded");
+    {
+        ResultWriter writer(fileName, ResultWriter::CSV);
+        writer.write(first);
+        writer.write(second);
+    }
+
+    std::vector<ResultRecord> read;
+    check(readResultRecords(fileName, read), fileName + " could not be read");
+    check(read.size() == 2, fileName + " should contain two records");
+    if (read.size() == 2) {
+        const ResultRecord::Field* queue = read[1].find("queue");
+        const ResultRecord::Field* hitRate = read[1].find("magazine_hit_rate");
+        double timeElapsed;
+        check(queue && queue->value == "sharded", fileName + ": the queue of the second record was misaligned");
+        check(hitRate && hitRate->value.empty(), fileName + ": the missing field of the second record should be empty");
+        check(read[1].get("time_elapsed_ns", timeElapsed) && timeElapsed == 2000.0, fileName + ": the time of the second record was misaligned");
+    }
+    std::remove(fileName.c_str());
+}
+
+int main() {
+    check(formatNumber(1e6) == "1000000", "1e6 should be formatted as 1000000 and not as " + formatNumber(1e6));
+    for (double rate : {1e6, 2.5e7, 1234.5, 1e12}) {
+        checkRoundTrip("result_records_test.csv", ResultWriter::CSV, rate);
+        checkRoundTrip("result_records_test.json", ResultWriter::JSON, rate);
+    }
+    checkDifferingFields("result_records_test.csv");
+    return failures == 0 ? 0 : 1;
+}